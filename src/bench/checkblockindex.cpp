@@ -3,10 +3,17 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <chain.h>
+#include <memusage.h>
+#include <node/blockstorage.h>
+#include <random.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
 #include <validation.h>
 
+#include <cassert>
 #include <memory>
+#include <vector>
 
 static void CheckBlockIndex(benchmark::Bench& bench)
 {
@@ -18,5 +25,54 @@ static void CheckBlockIndex(benchmark::Bench& bench)
     });
 }
 
+//! Build a block index of the given size as BlockManager does, with a fork every 100 blocks
+static std::vector<CBlockIndex*> BuildBlockIndex(node::BlockMap& block_index, int size)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CBlockIndex*> blocks;
+    blocks.reserve(size);
+    for (int i{0}; i < size; i++) {
+        const auto [it, inserted]{block_index.try_emplace(rng.rand256())};
+        CBlockIndex& index{it->second};
+        index.phashBlock = &it->first;
+        if (i > 0)
+            index.pprev = blocks[i % 100 == 0 ? rng.randrange(i) : i - 1];
+        index.nHeight = index.pprev ? index.pprev->nHeight + 1 : 0;
+        index.nChainWork = (index.pprev ? index.pprev->nChainWork : arith_uint256{}) + 1;
+        index.BuildSkip();
+        blocks.push_back(&index);
+    }
+    return blocks;
+}
+
+//! Times building the block index, and reports the memory it uses as it does not vary between runs
+static void BlockIndexBuild(benchmark::Bench& bench)
+{
+    constexpr int SIZE{100'000};
+    size_t usage{0};
+    bench.batch(SIZE).unit("block").run([&] {
+        node::BlockMap block_index;
+        BuildBlockIndex(block_index, SIZE);
+        usage = memusage::DynamicUsage(block_index);
+    });
+    assert(usage >= SIZE*sizeof(CBlockIndex));
+    if (bench.output())
+        *bench.output() << "Block index memory usage: " << usage/SIZE << " bytes per block\n";
+}
+
+static void BlockIndexAncestorWalk(benchmark::Bench& bench)
+{
+    node::BlockMap block_index;
+    const std::vector<CBlockIndex*> blocks{BuildBlockIndex(block_index, 100'000)};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    bench.run([&] {
+        const CBlockIndex* a{blocks[rng.randrange(blocks.size())]};
+        const CBlockIndex* b{blocks[rng.randrange(blocks.size())]};
+        ankerl::nanobench::doNotOptimizeAway(LastCommonAncestor(a, b));
+        ankerl::nanobench::doNotOptimizeAway(a->GetAncestor(rng.randrange(a->nHeight + 1)));
+    });
+}
 
 BENCHMARK(CheckBlockIndex);
+BENCHMARK(BlockIndexBuild);
+BENCHMARK(BlockIndexAncestorWalk);
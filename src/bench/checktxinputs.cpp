@@ -0,0 +1,39 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <consensus/amount.h>
+#include <consensus/tx_verify.h>
+#include <consensus/validation.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+
+#include <cassert>
+
+// Input checks of a transaction spending many Coins after the Blacklist activation, like a large consolidation in ConnectBlock or ATMP
+static void CheckTxInputsBench(benchmark::Bench& bench)
+{
+    static constexpr int NUM_INPUTS{2000};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CCoinsViewCache inputs{&CoinsViewEmpty::Get()};
+    CMutableTransaction mtx;
+    for (int i{0}; i < NUM_INPUTS; i++) {
+        const COutPoint prevout{Txid::FromUint256(rng.rand256()), 0};
+        inputs.AddCoin(prevout, Coin{{1 * COIN, CScript() << OP_0 << rng.randbytes(20)}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+        mtx.vin.emplace_back(prevout);
+    }
+    // Leave a fee, as a minimum one is enforced
+    mtx.vout.emplace_back((NUM_INPUTS - 1) * COIN, CScript() << OP_TRUE);
+    const CTransaction tx{mtx};
+
+    bench.batch(NUM_INPUTS).unit("input").run([&] {
+        TxValidationState state;
+        CAmount txfee{0};
+        assert(Consensus::CheckTxInputs(tx, state, inputs, /*nSpendHeight=*/3000000, txfee));
+    });
+}
+
+BENCHMARK(CheckTxInputsBench);
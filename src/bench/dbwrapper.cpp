@@ -0,0 +1,163 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <coins.h>
+#include <dbwrapper.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/byte_units.h>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr uint8_t DB_COIN{'C'};
+constexpr uint8_t DB_BLOCK_INDEX{'b'};
+
+std::unique_ptr<CDBWrapper> MakeDB(const BasicTestingSetup& setup, DBEngineType engine)
+{
+    return std::make_unique<CDBWrapper>(DBParams{
+        .path = setup.m_args.GetDataDirBase() / fs::u8path("bench_" + DBEngineTypeToString(engine)),
+        .cache_bytes = 8_MiB,
+        .wipe_data = true,
+        .obfuscate = true,
+        .options = {.engine = engine}});
+}
+
+Coin RandomCoin(FastRandomContext& rng)
+{
+    const CScript script{CScript{} << OP_0 << rng.randbytes(20)};
+    return Coin{CTxOut{static_cast<CAmount>(rng.randrange(100'000'000)), script}, static_cast<int>(rng.randrange(1'000'000)), false};
+}
+
+/** Flushes of the coins cache, where each block spends older outputs and creates new ones. */
+void UtxoFlush(benchmark::Bench& bench, DBEngineType engine)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const auto db{MakeDB(*testing_setup, engine)};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> unspent;
+    bench.batch(2000).unit("coin").run([&] {
+        CDBBatch batch{*db};
+        for (int i{0}; i < 1000; ++i) {
+            if (!unspent.empty()) {
+                const size_t spent{rng.randrange(unspent.size())};
+                batch.Erase(std::pair{DB_COIN, unspent[spent]});
+                unspent[spent] = unspent.back();
+                unspent.pop_back();
+            }
+            unspent.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(4));
+            batch.Write(std::pair{DB_COIN, unspent.back()}, RandomCoin(rng));
+            unspent.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(4));
+            batch.Write(std::pair{DB_COIN, unspent.back()}, RandomCoin(rng));
+        }
+        db->WriteBatch(batch, /*fSync=*/false);
+    });
+}
+
+/** Coins cache misses, read from the database. */
+void UtxoRead(benchmark::Bench& bench, DBEngineType engine)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const auto db{MakeDB(*testing_setup, engine)};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    CDBBatch batch{*db};
+    for (int i{0}; i < 200'000; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), 0);
+        batch.Write(std::pair{DB_COIN, outpoints.back()}, RandomCoin(rng));
+    }
+    db->WriteBatch(batch, /*fSync=*/true);
+    bench.unit("coin").run([&] {
+        Coin coin;
+        const bool found{db->Read(std::pair{DB_COIN, outpoints[rng.randrange(outpoints.size())]}, coin)};
+        assert(found);
+    });
+}
+
+/** Cursor positioned at a random coin to read a few, whose cost should not depend on the number of coins. */
+void Seek(benchmark::Bench& bench, DBEngineType engine, int coins)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const auto db{MakeDB(*testing_setup, engine)};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CDBBatch batch{*db};
+    for (int i{0}; i < coins; ++i) batch.Write(std::pair{DB_COIN, COutPoint{Txid::FromUint256(rng.rand256()), 0}}, RandomCoin(rng));
+    db->WriteBatch(batch, /*fSync=*/true);
+    bench.unit("seek").run([&] {
+        const std::unique_ptr<CDBIterator> cursor{db->NewIterator()};
+        cursor->Seek(std::pair{DB_COIN, COutPoint{Txid::FromUint256(rng.rand256()), 0}});
+        for (int i{0}; i < 10 && cursor->Valid(); ++i, cursor->Next()) {
+            Coin coin;
+            const bool read{cursor->GetValue(coin)};
+            assert(read);
+        }
+    });
+}
+
+/** Load of the block index at startup, iterating over all its entries. */
+void BlockIndexLoad(benchmark::Bench& bench, DBEngineType engine)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const auto db{MakeDB(*testing_setup, engine)};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    constexpr int BLOCKS{50'000};
+    CDBBatch batch{*db};
+    for (int height{0}; height < BLOCKS; ++height) {
+        CBlockIndex index;
+        index.nHeight = height;
+        index.nStatus = BLOCK_VALID_SCRIPTS | BLOCK_HAVE_DATA | BLOCK_HAVE_UNDO;
+        index.nTx = 1 + rng.randrange(3000);
+        index.nFile = height / 1000;
+        index.nDataPos = rng.randrange(128_MiB);
+        index.nUndoPos = rng.randrange(16_MiB);
+        index.nTime = 1'700'000'000 + 150 * height;
+        const uint256 hash{rng.rand256()};
+        batch.Write(std::pair{DB_BLOCK_INDEX, hash}, CDiskBlockIndex{&index});
+    }
+    db->WriteBatch(batch, /*fSync=*/true);
+    bench.batch(BLOCKS).unit("block").run([&] {
+        const std::unique_ptr<CDBIterator> cursor{db->NewIterator()};
+        cursor->Seek(std::pair{DB_BLOCK_INDEX, uint256{}});
+        int loaded{0};
+        for (std::pair<uint8_t, uint256> key; cursor->Valid() && cursor->GetKey(key) && key.first == DB_BLOCK_INDEX; cursor->Next()) {
+            CDiskBlockIndex index;
+            const bool read{cursor->GetValue(index)};
+            assert(read);
+            ++loaded;
+        }
+        assert(loaded == BLOCKS);
+    });
+}
+
+void DBWrapperUtxoFlushLevelDB(benchmark::Bench& bench) { UtxoFlush(bench, DBEngineType::LEVELDB); }
+void DBWrapperUtxoFlushLogDB(benchmark::Bench& bench) { UtxoFlush(bench, DBEngineType::LOGDB); }
+void DBWrapperUtxoReadLevelDB(benchmark::Bench& bench) { UtxoRead(bench, DBEngineType::LEVELDB); }
+void DBWrapperUtxoReadLogDB(benchmark::Bench& bench) { UtxoRead(bench, DBEngineType::LOGDB); }
+void DBWrapperSeekSmallLevelDB(benchmark::Bench& bench) { Seek(bench, DBEngineType::LEVELDB, 10'000); }
+void DBWrapperSeekSmallLogDB(benchmark::Bench& bench) { Seek(bench, DBEngineType::LOGDB, 10'000); }
+void DBWrapperSeekLargeLevelDB(benchmark::Bench& bench) { Seek(bench, DBEngineType::LEVELDB, 200'000); }
+void DBWrapperSeekLargeLogDB(benchmark::Bench& bench) { Seek(bench, DBEngineType::LOGDB, 200'000); }
+void DBWrapperBlockIndexLoadLevelDB(benchmark::Bench& bench) { BlockIndexLoad(bench, DBEngineType::LEVELDB); }
+void DBWrapperBlockIndexLoadLogDB(benchmark::Bench& bench) { BlockIndexLoad(bench, DBEngineType::LOGDB); }
+} // namespace
+
+BENCHMARK(DBWrapperUtxoFlushLevelDB);
+BENCHMARK(DBWrapperUtxoFlushLogDB);
+BENCHMARK(DBWrapperUtxoReadLevelDB);
+BENCHMARK(DBWrapperUtxoReadLogDB);
+BENCHMARK(DBWrapperSeekSmallLevelDB);
+BENCHMARK(DBWrapperSeekSmallLogDB);
+BENCHMARK(DBWrapperSeekLargeLevelDB);
+BENCHMARK(DBWrapperSeekLargeLogDB);
+BENCHMARK(DBWrapperBlockIndexLoadLevelDB);
+BENCHMARK(DBWrapperBlockIndexLoadLogDB);
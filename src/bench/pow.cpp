@@ -0,0 +1,195 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <checkqueue.h>
+#include <common/system.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// Riecoin Headers are typically downloaded by batches of 2000
+static constexpr size_t HEADER_BATCH_SIZE{2000};
+
+// Consensus Parameters of the given Chain, without the Genesis Block exception, so the Genesis Block PoW can be actually checked
+static Consensus::Params ParamsWithoutGenesisException(const CChainParams& chainParams)
+{
+    Consensus::Params params(chainParams.GetConsensus());
+    params.hashGenesisBlockForPoW.SetNull();
+    return params;
+}
+
+// Valid PoW of real Headers. The Genesis Blocks are the only real Headers available in the tree: TestNet (Prime Quintuplet, Difficulty 512) and RegTest (single Prime, Difficulty 288)
+static void CheckValidPoW(benchmark::Bench& bench, const CChainParams& chainParams, size_t batchSize)
+{
+    const Consensus::Params params(ParamsWithoutGenesisException(chainParams));
+    const CBlockHeader& header(chainParams.GenesisBlock());
+    const uint256 hashForPoW(header.GetHashForPoW()), nonce(ArithToUint256(header.nNonce));
+    assert(CheckProofOfWorkImpl(hashForPoW, header.nBits, nonce, params));
+    if (batchSize > 1) bench.epochs(3).epochIterations(1); // A batch of valid Headers takes seconds
+    bench.batch(batchSize).unit("header").run([&] {
+        for (size_t i(0) ; i < batchSize ; i++)
+            assert(CheckProofOfWorkImpl(hashForPoW, header.nBits, nonce, params));
+    });
+}
+
+static void CheckProofOfWorkTestNetQuintuplet(benchmark::Bench& bench) {CheckValidPoW(bench, *CChainParams::TestNet(), 1);}
+static void CheckProofOfWorkTestNetQuintupletBatch(benchmark::Bench& bench) {CheckValidPoW(bench, *CChainParams::TestNet(), HEADER_BATCH_SIZE);}
+static void CheckProofOfWorkRegTest(benchmark::Bench& bench) {CheckValidPoW(bench, *CChainParams::RegTest(), 1);}
+
+// Invalid PoW with random Hashes and Offsets at MainNet Difficulties, for each PoW Version. This is the cost of rejecting bogus Headers, most candidates being eliminated by the sieve
+struct PoWCandidate {
+    uint256 hash;
+    uint256 nonce;
+};
+
+static std::vector<PoWCandidate> MainNetCandidates(const int32_t powVersion, const size_t count)
+{
+    FastRandomContext rng(/*fDeterministic=*/true);
+    std::vector<PoWCandidate> candidates(count);
+    for (PoWCandidate& candidate : candidates) {
+        candidate.hash = rng.rand256();
+        if (powVersion == -1) // Offset below 2^32, which is allowed at any Difficulty
+            candidate.nonce = ArithToUint256(arith_uint256(rng.rand32() | 1U));
+        else { // [31-30 Primorial Number|29-14 Primorial Factor|13-2 Primorial Offset|1-0 Version], with the Primorial of the first 40 Primes and a 64 bits Primorial Factor
+            arith_uint256 nonce(40);
+            nonce <<= 128;
+            nonce += rng.rand64();
+            nonce <<= 112;
+            nonce += arith_uint256(rng.rand64()) << 16;
+            nonce += 2;
+            candidate.nonce = ArithToUint256(nonce);
+        }
+    }
+    return candidates;
+}
+
+static void CheckInvalidPoW(benchmark::Bench& bench, const int32_t powVersion, const uint32_t difficulty, const size_t batchSize)
+{
+    const Consensus::Params params(CChainParams::Main()->GetConsensus());
+    const uint32_t nBits(powVersion == -1 ? (0x02000000U | (difficulty << 8U)) : difficulty*256U); // The Legacy nBits is the Compact encoding of the Difficulty
+    const std::vector<PoWCandidate> candidates(MainNetCandidates(powVersion, batchSize));
+    bench.batch(batchSize).unit("header").run([&] {
+        for (const PoWCandidate& candidate : candidates)
+            assert(!CheckProofOfWorkImpl(candidate.hash, nBits, candidate.nonce, params));
+    });
+}
+
+static void CheckProofOfWorkLegacySextuplet304(benchmark::Bench& bench) {CheckInvalidPoW(bench, -1, 304, 64);}
+static void CheckProofOfWorkLegacySextuplet2564(benchmark::Bench& bench) {CheckInvalidPoW(bench, -1, 2564, 64);}
+static void CheckProofOfWorkSeptuplet600(benchmark::Bench& bench) {CheckInvalidPoW(bench, 1, 600, 64);}
+static void CheckProofOfWorkSeptuplet1200(benchmark::Bench& bench) {CheckInvalidPoW(bench, 1, 1200, 64);}
+static void CheckProofOfWorkSeptuplet2400(benchmark::Bench& bench) {CheckInvalidPoW(bench, 1, 2400, 64);}
+static void CheckProofOfWorkSeptupletBatch(benchmark::Bench& bench) {CheckInvalidPoW(bench, 1, 1200, HEADER_BATCH_SIZE);}
+
+// A batch of valid Headers through the parallel PoW Check Queue used by ProcessNewBlockHeaders
+static void CheckProofOfWorkQueueBatch(benchmark::Bench& bench)
+{
+    // We shouldn't ever be running with the checkqueue on a single core machine.
+    if (GetNumCores() <= 1) return;
+
+    const auto chainParams(CChainParams::TestNet());
+    const Consensus::Params params(ParamsWithoutGenesisException(*chainParams));
+    const std::vector<CBlockHeader> headers(HEADER_BATCH_SIZE, chainParams->GenesisBlock());
+    CCheckQueue<CPoWCheck> queue{/*batch_size=*/4, GetNumCores() - 1, "PoW", "powch"};
+    bench.epochs(3).epochIterations(1).batch(headers.size()).unit("header").run([&] {
+        std::vector<uint8_t> verified(headers.size(), 0);
+        std::vector<CPoWCheck> checks;
+        checks.reserve(headers.size());
+        for (size_t i(0) ; i < headers.size() ; i++)
+            checks.emplace_back(headers[i], params, verified[i]);
+        CCheckQueueControl<CPoWCheck> control(queue);
+        control.Add(std::move(checks));
+        assert(!control.Complete());
+    });
+}
+
+static void DeriveTargetLegacy(benchmark::Bench& bench)
+{
+    const uint256 hash(FastRandomContext(/*fDeterministic=*/true).rand256());
+    bench.run([&] {
+        ankerl::nanobench::doNotOptimizeAway(DeriveTarget(hash, 0x02013000, 0, -1, 0));
+    });
+}
+
+static void DeriveTargetV1(benchmark::Bench& bench)
+{
+    const uint256 hash(FastRandomContext(/*fDeterministic=*/true).rand256());
+    bench.run([&] {
+        ankerl::nanobench::doNotOptimizeAway(DeriveTarget(hash, 1200*256, 0, 1, 600*256));
+    });
+}
+
+// Difficulty Adjustment after Fork 2 (ASERT)
+static void CalculateNextWorkRequiredAsert(benchmark::Bench& bench)
+{
+    const Consensus::Params params(CChainParams::Main()->GetConsensus());
+    CBlockIndex pindexLast;
+    pindexLast.nHeight = params.fork2Height + 1000;
+    pindexLast.nTime = 1700000000;
+    pindexLast.nBits = 1200*256;
+    int64_t solveTime(0);
+    bench.run([&] {
+        solveTime = (solveTime + 37) % 1800;
+        ankerl::nanobench::doNotOptimizeAway(CalculateNextWorkRequired(&pindexLast, pindexLast.nTime - solveTime, params));
+    });
+}
+
+// Block Proofs of MainNet Block Indexes around Fork 2, like when computing the nChainWork while loading the Block Index
+static void GetBlockProofBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::MAIN)};
+    const Consensus::Params& consensusParams(Params().GetConsensus());
+    std::vector<CBlockIndex> blocks(1000);
+    for (size_t i(0) ; i < blocks.size() ; i++) {
+        blocks[i].nHeight = consensusParams.fork2Height - blocks.size()/2 + i;
+        blocks[i].nBits = blocks[i].nHeight < consensusParams.fork2Height ? 0x0207a800 + 256*(i % 64) : 1300*256 + i;
+    }
+    bench.batch(blocks.size()).unit("block").run([&] {
+        arith_uint256 chainWork;
+        for (const CBlockIndex& block : blocks)
+            chainWork += GetBlockProof(block);
+        ankerl::nanobench::doNotOptimizeAway(chainWork);
+    });
+}
+
+// Legacy (before Fork 2) Difficulty Adjustment
+static void CalculateNextWorkRequiredLegacy(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>(ChainType::MAIN)};
+    const Consensus::Params& consensusParams(Params().GetConsensus());
+    CBlockIndex pindexLast;
+    pindexLast.nHeight = 288*1000 - 1;
+    pindexLast.nTime = 1500000000;
+    pindexLast.nBits = 0x0207a800;
+    bench.run([&] {
+        ankerl::nanobench::doNotOptimizeAway(CalculateNextWorkRequired(&pindexLast, pindexLast.nTime - 43200, consensusParams));
+    });
+}
+
+BENCHMARK(CheckProofOfWorkTestNetQuintuplet);
+BENCHMARK(CheckProofOfWorkTestNetQuintupletBatch);
+BENCHMARK(CheckProofOfWorkRegTest);
+BENCHMARK(CheckProofOfWorkLegacySextuplet304);
+BENCHMARK(CheckProofOfWorkLegacySextuplet2564);
+BENCHMARK(CheckProofOfWorkSeptuplet600);
+BENCHMARK(CheckProofOfWorkSeptuplet1200);
+BENCHMARK(CheckProofOfWorkSeptuplet2400);
+BENCHMARK(CheckProofOfWorkSeptupletBatch);
+BENCHMARK(CheckProofOfWorkQueueBatch);
+BENCHMARK(DeriveTargetLegacy);
+BENCHMARK(DeriveTargetV1);
+BENCHMARK(CalculateNextWorkRequiredAsert);
+BENCHMARK(GetBlockProofBench);
+BENCHMARK(CalculateNextWorkRequiredLegacy);
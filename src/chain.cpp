@@ -7,10 +7,15 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <cmath>
+#include <limits>
 #include <rpc/blockchain.h>
 #include <tinyformat.h>
 #include <util/check.h>
 
+// The walked fields must stay within the first 64 bytes, so at most two cache lines, and the layout free of padding holes
+static_assert(offsetof(CBlockIndex, phashBlock) + sizeof(const uint256*) <= 64);
+static_assert(sizeof(CBlockIndex) <= 184);
+
 std::string CBlockIndex::ToString() const
 {
     return strprintf("CBlockIndex(pprev=%p, nHeight=%d, merkle=%s, hashBlock=%s)",
@@ -130,18 +135,27 @@ We are using floating point number as perfect precision is not critical here. */
 arith_uint256 GetBlockProof(const CBlockIndex& block)
 {
     const Consensus::Params& consensusParams(Params().GetConsensus());
-    double difficulty(0.),
-           constellationSize(consensusParams.GetPowAcceptedPatternsAtHeight(block.nHeight)[0].size());
+    double difficulty(0.);
+    const double constellationSize(consensusParams.GetConstellationSizeAtHeight(block.nHeight));
     const uint32_t nBits(block.nBits);
-    const int32_t powVersion(Params().GetConsensus().GetPoWVersionAtHeight(block.nHeight));
+    const int32_t powVersion(consensusParams.GetPoWVersionAtHeight(block.nHeight));
     if (powVersion == -1)
         difficulty = (nBits & 0x007FFFFFU) >> 8U; // The original PoW used the Bitcoin Compact format. This formula is equivalent for any block before Fork 2.
     else if (powVersion == 1)
         difficulty = static_cast<double>(nBits)/256.;
-    double proof(std::pow(difficulty, constellationSize + 2.3));
-    std::string proofStr(mpz_class(proof).get_str(16));
-    proofStr = std::string(64U - proofStr.length(), '0') + proofStr;
-    arith_uint256 proofAU256(UintToArith256(uint256::FromHex(proofStr).value()));
+    const double proof(std::pow(difficulty, constellationSize + 2.3));
+    // Truncate the Proof to an integer: split it into a 53 bits Mantissa and a power of 2 that is applied by shifting
+    if (proof < 1.)
+        return 0;
+    int exponent;
+    const double fraction(std::frexp(proof, &exponent));
+    Assume(exponent <= 256);
+    arith_uint256 proofAU256(static_cast<uint64_t>(std::ldexp(fraction, std::numeric_limits<double>::digits)));
+    exponent -= std::numeric_limits<double>::digits;
+    if (exponent >= 0)
+        proofAU256 <<= exponent;
+    else
+        proofAU256 >>= -exponent;
     return proofAU256;
 }
 
@@ -96,8 +96,11 @@ enum BlockStatus : uint32_t {
 class CBlockIndex
 {
 public:
-    //! pointer to the hash of the block, if any. Memory is owned by this CBlockIndex
-    const uint256* phashBlock{nullptr};
+    // The fields used when walking the tree (GetAncestor, LastCommonAncestor, CChain::FindFork
+    // and the work comparisons) come first and fit in 64 bytes. The BlockMap nodes place the entry
+    // behind their next pointer and key, at 8 mod 16 bytes, so these fields span two cache lines
+    // at most instead of the whole entry. The header fields only needed to serve or check the block
+    // come last.
 
     //! pointer to the index of the predecessor of this block
     CBlockIndex* pprev{nullptr};
@@ -108,22 +111,25 @@ public:
     //! height of the entry in the chain. The genesis block has height 0
     int nHeight{0};
 
-    //! Which # file this block is stored in (blk?????.dat)
-    int nFile GUARDED_BY(::cs_main){0};
-
-    //! Byte offset within blk?????.dat where this block's data is stored
-    unsigned int nDataPos GUARDED_BY(::cs_main){0};
-
-    //! Byte offset within rev?????.dat where this block's undo data is stored
-    unsigned int nUndoPos GUARDED_BY(::cs_main){0};
+    //! Verification status of this block. See enum BlockStatus
+    //!
+    //! Note: this value is modified to show BLOCK_OPT_WITNESS during UTXO snapshot
+    //! load to avoid a spurious startup failure requiring -reindex.
+    //! @sa NeedsRedownload
+    //! @sa ActivateSnapshot
+    uint32_t nStatus GUARDED_BY(::cs_main){0};
 
     //! (memory only) Total amount of work (expected number of hashes) in the chain up to and including this block
     arith_uint256 nChainWork{};
 
-    //! Number of transactions in this block. This will be nonzero if the block
-    //! reached the VALID_TRANSACTIONS level, and zero otherwise.
-    //! Note: in a potential headers-first mode, this number cannot be relied upon
-    unsigned int nTx{0};
+    //! pointer to the hash of the block, if any. Memory is owned by this CBlockIndex
+    const uint256* phashBlock{nullptr};
+
+    //! block header, also read by the median time past walks
+    int64_t nTime{0};
+
+    //! (memory only) Maximum nTime in the chain up to and including this block.
+    int64_t nTimeMax{0};
 
     //! (memory only) Number of transactions in the chain up to and including this block.
     //! This value will be non-zero if this block and all previous blocks back
@@ -131,34 +137,38 @@ public:
     //! VALID_TRANSACTIONS level.
     uint64_t m_chain_tx_count{0};
 
-    //! Verification status of this block. See enum BlockStatus
-    //!
-    //! Note: this value is modified to show BLOCK_OPT_WITNESS during UTXO snapshot
-    //! load to avoid a spurious startup failure requiring -reindex.
-    //! @sa NeedsRedownload
-    //! @sa ActivateSnapshot
-    uint32_t nStatus GUARDED_BY(::cs_main){0};
+    //! Number of transactions in this block. This will be nonzero if the block
+    //! reached the VALID_TRANSACTIONS level, and zero otherwise.
+    //! Note: in a potential headers-first mode, this number cannot be relied upon
+    unsigned int nTx{0};
 
     //! block header
-    int32_t nVersion{0};
-    uint256 hashMerkleRoot{};
-    int64_t nTime{0};
     uint32_t nBits{0};
-    arith_uint256 nNonce{0};
+    int32_t nVersion{0};
 
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     //! Initialized to SEQ_ID_INIT_FROM_DISK{1} when loading blocks from disk, except for blocks
     //! belonging to the best chain which overwrite it to SEQ_ID_BEST_CHAIN_FROM_DISK{0}.
     int32_t nSequenceId{SEQ_ID_INIT_FROM_DISK};
 
-    //! (memory only) Maximum nTime in the chain up to and including this block.
-    int64_t nTimeMax{0};
+    //! Which # file this block is stored in (blk?????.dat)
+    int nFile GUARDED_BY(::cs_main){0};
+
+    //! Byte offset within blk?????.dat where this block's data is stored
+    unsigned int nDataPos GUARDED_BY(::cs_main){0};
+
+    //! Byte offset within rev?????.dat where this block's undo data is stored
+    unsigned int nUndoPos GUARDED_BY(::cs_main){0};
+
+    //! block header, cold
+    uint256 hashMerkleRoot{};
+    arith_uint256 nNonce{0};
 
     explicit CBlockIndex(const CBlockHeader& block)
-        : nVersion{block.nVersion},
-          hashMerkleRoot{block.hashMerkleRoot},
-          nTime{block.nTime},
+        : nTime{block.nTime},
           nBits{block.nBits},
+          nVersion{block.nVersion},
+          hashMerkleRoot{block.hashMerkleRoot},
           nNonce{block.nNonce}
     {
     }
@@ -332,9 +342,23 @@ public:
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
     }
 
-    SERIALIZE_METHODS(CDiskBlockIndex, obj)
+    template <typename Stream>
+    void Serialize(Stream& s) const
     {
         LOCK(::cs_main);
+        Ser(s, *this);
+    }
+
+    //! Does not take cs_main, as the entry being read is not shared yet. This lets the block
+    //! index be read by several threads while the one waiting for them holds cs_main.
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        Unser(s, *this);
+    }
+
+    FORMATTER_METHODS(CDiskBlockIndex, obj) NO_THREAD_SAFETY_ANALYSIS
+    {
         int _nVersion = DUMMY_VERSION;
         READWRITE(VARINT_MODE(_nVersion, VarIntMode::NONNEGATIVE_SIGNED));
 
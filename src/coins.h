@@ -15,6 +15,7 @@
 #include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/flatnodemap.h>
 #include <util/overflow.h>
 #include <util/hasher.h>
 
@@ -22,7 +23,10 @@
 #include <cstdint>
 
 #include <functional>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
  * A UTXO entry.
@@ -209,19 +213,15 @@ public:
 };
 
 /**
- * PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter here uses sizeof the data, and adds the size
- * of 4 pointers. We do not know the exact node size used in the std::unordered_node implementation
- * because it is implementation defined. Most implementations have an overhead of 1 or 2 pointers,
- * so nodes can be connected in a linked list, and in some cases the hash value is stored as well.
- * Using an additional sizeof(void*)*4 for MAX_BLOCK_SIZE_BYTES should thus be sufficient so that
- * all implementations can allocate the nodes from the PoolAllocator.
+ * The entries are allocated one by one from the PoolAllocator, and the table only holds pointers to them,
+ * so their addresses are stable for the linked list of flagged entries. As the nodes are exactly the
+ * CoinsCachePair, it is used for the PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter.
  */
-using CCoinsMap = std::unordered_map<COutPoint,
-                                     CCoinsCacheEntry,
-                                     SaltedOutpointHasher,
-                                     std::equal_to<COutPoint>,
-                                     PoolAllocator<CoinsCachePair,
-                                                   sizeof(CoinsCachePair) + sizeof(void*) * 4>>;
+using CCoinsMap = FlatNodeMap<COutPoint,
+                              CCoinsCacheEntry,
+                              SaltedOutpointHasher,
+                              std::equal_to<COutPoint>,
+                              PoolAllocator<CoinsCachePair, sizeof(CoinsCachePair)>>;
 
 using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
 
@@ -415,7 +415,7 @@ protected:
      * Discard all modifications made to this cache without flushing to the base view.
      * This can be used to efficiently reuse a cache instance across multiple operations.
      */
-    void Reset() noexcept;
+    virtual void Reset() noexcept;
 
     /* Fetch the coin from base. Used for cache misses in FetchCoin. */
     virtual std::optional<Coin> FetchCoinFromBase(const COutPoint& outpoint) const;
@@ -446,6 +446,12 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Check if this cache has an entry for the given outpoint, including a
+     * spent one that is not flushed yet and so hides the coin in the base view.
+     */
+    bool HaveEntryInCache(const COutPoint& outpoint) const;
+
     /**
      * Return a reference to Coin in the cache, or coinEmpty if not found. This is
      * more efficient than GetCoin.
@@ -564,13 +570,34 @@ private:
 class CoinsViewOverlay : public CCoinsViewCache
 {
 private:
+    //! Coins (or their absence) read ahead from the base view, see SetPrefetchedCoins
+    std::unordered_map<COutPoint, std::optional<Coin>, SaltedOutpointHasher> m_prefetched_coins;
+
     std::optional<Coin> FetchCoinFromBase(const COutPoint& outpoint) const override
     {
+        if (const auto it{m_prefetched_coins.find(outpoint)}; it != m_prefetched_coins.end()) return it->second;
         return base->PeekCoin(outpoint);
     }
 
+protected:
+    void Reset() noexcept override
+    {
+        m_prefetched_coins.clear();
+        CCoinsViewCache::Reset();
+    }
+
 public:
     using CCoinsViewCache::CCoinsViewCache;
+
+    /**
+     * Use coins read ahead from the base view, for example in parallel, instead of reading them
+     * again on cache misses. The base view must not change until the next Reset().
+     */
+    void SetPrefetchedCoins(std::vector<std::pair<COutPoint, std::optional<Coin>>>&& coins)
+    {
+        m_prefetched_coins.reserve(m_prefetched_coins.size() + coins.size());
+        for (auto& [outpoint, coin] : coins) m_prefetched_coins.emplace(outpoint, std::move(coin));
+    }
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
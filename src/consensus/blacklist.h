@@ -9,7 +9,7 @@
 
 using namespace util::hex_literals;
 
-static const Blacklist blacklist = {
+static const Blacklist blacklist{
 	{
 		// Poloniex (Exchange Delisting, Known Addresses)
 		CScript() << OP_DUP << OP_HASH160 << "7f8e8b4e8d14e867987a62242bc25458ec8a2b94"_hex << OP_EQUALVERIFY << OP_CHECKSIG,
@@ -76,6 +76,7 @@ struct Params {
     int32_t GetPoWVersionAtHeight(int32_t height) const {return height < fork2Height ? -1 : 1;}
     std::vector<std::vector<int32_t>> powAcceptedPatterns;
     std::vector<std::vector<int32_t>> GetPowAcceptedPatternsAtHeight(int height) const {return height >= fork2Height ? powAcceptedPatterns : std::vector<std::vector<int32_t>>{{0, 4, 2, 4, 2, 4}};} // MainNet Only: Prime Sextuplets prior Fork 2
+    size_t GetConstellationSizeAtHeight(int height) const {return height >= fork2Height ? powAcceptedPatterns[0].size() : 6U;} // Same as GetPowAcceptedPatternsAtHeight(height)[0].size(), without copying the Patterns
     uint32_t nBitsMin;
     bool fPowNoRetargeting;
     int64_t nPowTargetSpacing;
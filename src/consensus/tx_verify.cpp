@@ -172,13 +172,14 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state,
                          strprintf("%s: inputs missing/spent", __func__));
     }
 
+    static const CScript specTradeScript(CScript() << OP_1 << "c19e658a0ed6120f8db45a28bce492e1c95700809127ee5e152995784b548b24"_hex);
     CAmount nValueIn = 0;
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
         const COutPoint &prevout = tx.vin[i].prevout;
         const Coin& coin = inputs.AccessCoin(prevout);
         assert(!coin.IsSpent());
 
-        if (coin.out.scriptPubKey == (CScript() << OP_1 << "c19e658a0ed6120f8db45a28bce492e1c95700809127ee5e152995784b548b24"_hex)) {
+        if (coin.out.scriptPubKey == specTradeScript) {
             if (nSpendHeight > 2662380) // Limit Hard Fork Risk from recently disabled Script by giving enough time to upgrade to 2511+.
                 return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-disabled-script");
         }
@@ -0,0 +1,93 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_DBENGINE_H
+#define BITCOIN_DBENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/** Writes and erasures applied atomically by DBEngine::Write. */
+class DBEngineBatch
+{
+public:
+    virtual ~DBEngineBatch() = default;
+
+    virtual void Put(std::span<const std::byte> key, std::span<const std::byte> value) = 0;
+    virtual void Delete(std::span<const std::byte> key) = 0;
+    virtual void Clear() = 0;
+    virtual size_t ApproximateSize() const = 0;
+};
+
+/** Iterator over the entries of a DBEngine in the bytewise order of their keys. */
+class DBEngineIterator
+{
+public:
+    virtual ~DBEngineIterator() = default;
+
+    virtual bool Valid() const = 0;
+    virtual void SeekToFirst() = 0;
+    //! Move to the first entry whose key is not smaller than the given one
+    virtual void Seek(std::span<const std::byte> key) = 0;
+    virtual void Next() = 0;
+    //! The returned spans are only valid until the iterator is moved.
+    virtual std::span<const std::byte> Key() const = 0;
+    virtual std::span<const std::byte> Value() const = 0;
+};
+
+/** Counters of a DBEngine since it was opened, for diagnosing its performance. */
+struct DBStats {
+    struct Level {
+        size_t files{0};
+        uint64_t bytes{0};
+        //! Time spent compacting into this level, and the data read and written doing so
+        double compaction_seconds{0};
+        uint64_t compaction_read_bytes{0};
+        uint64_t compaction_written_bytes{0};
+    };
+    //! Levels of the tree from the newest data to the oldest, or a single one for flat engines
+    std::vector<Level> levels;
+    //! Point lookups, and the file blocks they read that were not cached. Their ratio is the
+    //! read amplification.
+    uint64_t lookups{0};
+    uint64_t lookup_file_reads{0};
+    //! Bloom filter probes, and those which ruled out the key without reading the file. Unset
+    //! when the engine has no bloom filters.
+    std::optional<uint64_t> bloom_checks{};
+    std::optional<uint64_t> bloom_rejections{};
+    //! Writes delayed by 1ms as compaction fell behind, and writes which waited for it
+    uint64_t write_slowdowns{0};
+    uint64_t write_stalls{0};
+    size_t memory_usage{0};
+};
+
+/**
+ * Ordered key-value store below CDBWrapper, which handles the serialization and obfuscation.
+ * It must be safe to call from several threads at once, and its errors are thrown as dbwrapper_error.
+ */
+class DBEngine
+{
+public:
+    virtual ~DBEngine() = default;
+
+    virtual std::optional<std::string> Read(std::span<const std::byte> key) const = 0;
+    virtual bool Exists(std::span<const std::byte> key) const = 0;
+    virtual std::unique_ptr<DBEngineBatch> NewBatch() const = 0;
+    //! Apply a batch created by NewBatch, durably if sync is set.
+    virtual void Write(DBEngineBatch& batch, bool sync) = 0;
+    virtual std::unique_ptr<DBEngineIterator> NewIterator() const = 0;
+    //! Approximate size on disk of the entries with keys in [begin, end)
+    virtual size_t EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const = 0;
+    virtual size_t DynamicMemoryUsage() const = 0;
+    //! Reclaim the space of all the overwritten and erased entries.
+    virtual void CompactAll() = 0;
+    virtual DBStats GetStats() const = 0;
+};
+
+#endif // BITCOIN_DBENGINE_H
@@ -14,31 +14,40 @@
 #include <leveldb/slice.h>
 #include <leveldb/status.h>
 #include <leveldb/write_batch.h>
+#include <logdb.h>
 #include <random.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <tinyformat.h>
 #include <util/byte_units.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/log.h>
 #include <util/obfuscation.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 #include <optional>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 static auto CharCast(const std::byte* data) { return reinterpret_cast<const char*>(data); }
 
 bool DestroyDB(const std::string& path_str)
 {
-    return leveldb::DestroyDB(path_str, {}).ok();
+    // LogDB first, as LevelDB removes the directory once it is empty
+    const bool logdb_destroyed{LogDB::Destroy(fs::PathFromString(path_str))};
+    return leveldb::DestroyDB(path_str, {}).ok() && logdb_destroyed;
 }
 
 /** Handle database error by throwing dbwrapper_error exception.
@@ -53,11 +62,35 @@ static void HandleError(const leveldb::Status& status)
     throw dbwrapper_error(errmsg);
 }
 
+namespace {
+//! Counters of a LevelDBEngine, updated from the threads of LevelDB
+struct LevelDBCounters {
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> lookup_file_reads{0};
+    std::atomic<uint64_t> bloom_checks{0};
+    std::atomic<uint64_t> bloom_rejections{0};
+    std::atomic<uint64_t> write_slowdowns{0};
+    std::atomic<uint64_t> write_stalls{0};
+};
+
+//! Whether this thread is in a point lookup, so that the file reads are attributed to it
+thread_local bool g_in_lookup{false};
+} // namespace
+
 class CBitcoinLevelDBLogger : public leveldb::Logger {
+private:
+    LevelDBCounters& m_counters;
+
 public:
+    explicit CBitcoinLevelDBLogger(LevelDBCounters& counters) : m_counters{counters} {}
+
     // This code is adapted from posix_logger.h, which is why it is using vsprintf.
     // Please do not do this in normal code
     void Logv(const char * format, va_list ap) override {
+            // LevelDB only reports the writes waiting for a compaction through its log
+            if (std::strcmp(format, "Current memtable full; waiting...\n") == 0 || std::strcmp(format, "Too many L0 files; waiting...\n") == 0) {
+                ++m_counters.write_stalls;
+            }
             if (!util::log::ShouldDebugLog(BCLog::LEVELDB)) {
                 return;
             }
@@ -136,14 +169,88 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+namespace {
+class CountingRandomAccessFile final : public leveldb::RandomAccessFile
+{
+private:
+    const std::unique_ptr<leveldb::RandomAccessFile> m_file;
+    LevelDBCounters& m_counters;
+
+public:
+    CountingRandomAccessFile(leveldb::RandomAccessFile* file, LevelDBCounters& counters) : m_file{file}, m_counters{counters} {}
+
+    leveldb::Status Read(uint64_t offset, size_t n, leveldb::Slice* result, char* scratch) const override
+    {
+        if (g_in_lookup) ++m_counters.lookup_file_reads;
+        return m_file->Read(offset, n, result, scratch);
+    }
+
+    std::string GetName() const override { return m_file->GetName(); }
+};
+
+/** Env counting the file reads of the lookups, and the writes slowed down by LevelDB. */
+class CountingEnv final : public leveldb::EnvWrapper
 {
+private:
+    LevelDBCounters& m_counters;
+
+public:
+    CountingEnv(leveldb::Env* target, LevelDBCounters& counters) : EnvWrapper{target}, m_counters{counters} {}
+
+    leveldb::Status NewRandomAccessFile(const std::string& fname, leveldb::RandomAccessFile** result) override
+    {
+        const leveldb::Status status{target()->NewRandomAccessFile(fname, result)};
+        if (status.ok()) *result = new CountingRandomAccessFile(*result, m_counters);
+        return status;
+    }
+
+    //! LevelDB only sleeps to delay the writes while level 0 has many files.
+    void SleepForMicroseconds(int micros) override
+    {
+        ++m_counters.write_slowdowns;
+        target()->SleepForMicroseconds(micros);
+    }
+};
+
+class CountingFilterPolicy final : public leveldb::FilterPolicy
+{
+private:
+    const std::unique_ptr<const leveldb::FilterPolicy> m_policy;
+    LevelDBCounters& m_counters;
+
+public:
+    CountingFilterPolicy(const leveldb::FilterPolicy* policy, LevelDBCounters& counters) : m_policy{policy}, m_counters{counters} {}
+
+    //! The name of the wrapped policy, so that the filters of the existing files are still used
+    const char* Name() const override { return m_policy->Name(); }
+
+    void CreateFilter(const leveldb::Slice* keys, int n, std::string* dst) const override
+    {
+        m_policy->CreateFilter(keys, n, dst);
+    }
+
+    bool KeyMayMatch(const leveldb::Slice& key, const leveldb::Slice& filter) const override
+    {
+        ++m_counters.bloom_checks;
+        const bool match{m_policy->KeyMayMatch(key, filter)};
+        if (!match) ++m_counters.bloom_rejections;
+        return match;
+    }
+};
+} // namespace
+
+static leveldb::Options GetOptions(const DBParams& params, LevelDBCounters& counters)
+{
+    const size_t nCacheSize{params.cache_bytes};
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    options.block_cache = leveldb::NewLRUCache(params.options.block_cache_size.value_or(nCacheSize / 2));
+    options.write_buffer_size = params.options.write_buffer_size.value_or(nCacheSize / 4); // up to two write buffers may be held in memory simultaneously
+    if (params.options.bloom_bits > 0) {
+        options.filter_policy = new CountingFilterPolicy(leveldb::NewBloomFilterPolicy(params.options.bloom_bits), counters);
+    }
+    options.max_file_size = params.options.max_file_size.value_or(params.max_file_size);
     options.compression = leveldb::kNoCompression;
-    options.info_log = new CBitcoinLevelDBLogger();
+    options.info_log = new CBitcoinLevelDBLogger(counters);
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
         // on corruption in later versions.
@@ -153,50 +260,74 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-struct CDBBatch::WriteBatchImpl {
+namespace {
+class LevelDBBatch final : public DBEngineBatch
+{
+public:
     leveldb::WriteBatch batch;
+
+    void Put(std::span<const std::byte> key, std::span<const std::byte> value) override
+    {
+        leveldb::Slice slKey(CharCast(key.data()), key.size());
+        leveldb::Slice slValue(CharCast(value.data()), value.size());
+        batch.Put(slKey, slValue);
+    }
+
+    void Delete(std::span<const std::byte> key) override
+    {
+        leveldb::Slice slKey(CharCast(key.data()), key.size());
+        batch.Delete(slKey);
+    }
+
+    void Clear() override { batch.Clear(); }
+    size_t ApproximateSize() const override { return batch.ApproximateSize(); }
 };
 
-CDBBatch::CDBBatch(const CDBWrapper& _parent)
-    : parent{_parent},
-      m_impl_batch{std::make_unique<CDBBatch::WriteBatchImpl>()}
+class LevelDBIterator final : public DBEngineIterator
 {
-    m_key_scratch.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
-    m_value_scratch.reserve(DBWRAPPER_PREALLOC_VALUE_SIZE);
-    Clear();
-};
+public:
+    const std::unique_ptr<leveldb::Iterator> iter;
 
-CDBBatch::~CDBBatch() = default;
+    explicit LevelDBIterator(leveldb::Iterator* _iter) : iter{_iter} {}
 
-void CDBBatch::Clear()
-{
-    m_impl_batch->batch.Clear();
-    assert(m_key_scratch.empty());
-    assert(m_value_scratch.empty());
-}
+    bool Valid() const override { return iter->Valid(); }
+    void SeekToFirst() override { iter->SeekToFirst(); }
 
-void CDBBatch::WriteImpl(std::span<const std::byte> key, DataStream& value)
-{
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    dbwrapper_private::GetObfuscation(parent)(value);
-    leveldb::Slice slValue(CharCast(value.data()), value.size());
-    m_impl_batch->batch.Put(slKey, slValue);
-}
+    void Seek(std::span<const std::byte> key) override
+    {
+        leveldb::Slice slKey(CharCast(key.data()), key.size());
+        iter->Seek(slKey);
+    }
 
-void CDBBatch::EraseImpl(std::span<const std::byte> key)
-{
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    m_impl_batch->batch.Delete(slKey);
-}
+    void Next() override { iter->Next(); }
+    std::span<const std::byte> Key() const override { return MakeByteSpan(iter->key()); }
+    std::span<const std::byte> Value() const override { return MakeByteSpan(iter->value()); }
+};
 
-size_t CDBBatch::ApproximateSize() const
+class LevelDBEngine final : public DBEngine
 {
-    return m_impl_batch->batch.ApproximateSize();
-}
+public:
+    explicit LevelDBEngine(const DBParams& params);
+    ~LevelDBEngine() override;
+
+    std::optional<std::string> Read(std::span<const std::byte> key) const override;
+    bool Exists(std::span<const std::byte> key) const override;
+    std::unique_ptr<DBEngineBatch> NewBatch() const override { return std::make_unique<LevelDBBatch>(); }
+    void Write(DBEngineBatch& batch, bool sync) override;
+    std::unique_ptr<DBEngineIterator> NewIterator() const override;
+    size_t EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const override;
+    size_t DynamicMemoryUsage() const override;
+    void CompactAll() override { pdb->CompactRange(nullptr, nullptr); }
+    DBStats GetStats() const override;
+
+private:
+    mutable LevelDBCounters m_counters;
 
-struct LevelDBContext {
     //! custom environment this database is using (may be nullptr in case of default environment)
-    leveldb::Env* penv;
+    leveldb::Env* penv{nullptr};
+
+    //! wrapper of the environment, counting the file reads and the write slowdowns
+    std::unique_ptr<leveldb::Env> m_counting_env;
 
     //! database options used
     leveldb::Options options;
@@ -214,31 +345,30 @@ struct LevelDBContext {
     leveldb::WriteOptions syncoptions;
 
     //! the database itself
-    leveldb::DB* pdb;
+    leveldb::DB* pdb{nullptr};
 };
 
-CDBWrapper::CDBWrapper(const DBParams& params)
-    : m_db_context{std::make_unique<LevelDBContext>()}, m_name{fs::PathToString(params.path.stem())}
-{
-    DBContext().penv = nullptr;
-    DBContext().readoptions.verify_checksums = true;
-    DBContext().iteroptions.verify_checksums = true;
-    DBContext().iteroptions.fill_cache = false;
-    DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
-    DBContext().options.create_if_missing = true;
-    DBContext().options.max_file_size = params.max_file_size;
+LevelDBEngine::LevelDBEngine(const DBParams& params)
+{
+    readoptions.verify_checksums = true;
+    iteroptions.verify_checksums = true;
+    iteroptions.fill_cache = false;
+    syncoptions.sync = true;
+    options = GetOptions(params, m_counters);
+    options.create_if_missing = true;
     assert(!(params.testing_env && params.memory_only));
     if (params.testing_env) {
-        DBContext().options.env = params.testing_env;
+        options.env = params.testing_env;
     } else if (params.memory_only) {
-        DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
-        DBContext().options.env = DBContext().penv;
+        penv = leveldb::NewMemEnv(leveldb::Env::Default());
+        options.env = penv;
     }
+    m_counting_env = std::make_unique<CountingEnv>(options.env, m_counters);
+    options.env = m_counting_env.get();
     if (!params.memory_only) {
         if (params.wipe_data) {
             LogInfo("Wiping LevelDB in %s", fs::PathToString(params.path));
-            leveldb::Status result = leveldb::DestroyDB(fs::PathToString(params.path), DBContext().options);
+            leveldb::Status result = leveldb::DestroyDB(fs::PathToString(params.path), options);
             HandleError(result);
         }
         if (!params.testing_env) {
@@ -250,13 +380,223 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     // because on POSIX leveldb passes the byte string directly to ::open(), and
     // on Windows it converts from UTF-8 to UTF-16 before calling ::CreateFileW
     // (see env_posix.cc and env_windows.cc).
-    leveldb::Status status = leveldb::DB::Open(DBContext().options, fs::PathToString(params.path), &DBContext().pdb);
+    leveldb::Status status = leveldb::DB::Open(options, fs::PathToString(params.path), &pdb);
     HandleError(status);
     LogInfo("Opened LevelDB successfully");
+}
+
+LevelDBEngine::~LevelDBEngine()
+{
+    delete pdb;
+    pdb = nullptr;
+    delete options.filter_policy;
+    options.filter_policy = nullptr;
+    delete options.info_log;
+    options.info_log = nullptr;
+    delete options.block_cache;
+    options.block_cache = nullptr;
+    delete penv;
+    options.env = nullptr;
+}
+
+std::optional<std::string> LevelDBEngine::Read(std::span<const std::byte> key) const
+{
+    leveldb::Slice slKey(CharCast(key.data()), key.size());
+    std::string strValue;
+    ++m_counters.lookups;
+    g_in_lookup = true;
+    leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+    g_in_lookup = false;
+    if (!status.ok()) {
+        if (status.IsNotFound())
+            return std::nullopt;
+        LogError("LevelDB read failure: %s", status.ToString());
+        HandleError(status);
+    }
+    return strValue;
+}
+
+bool LevelDBEngine::Exists(std::span<const std::byte> key) const
+{
+    leveldb::Slice slKey(CharCast(key.data()), key.size());
 
+    std::string strValue;
+    ++m_counters.lookups;
+    g_in_lookup = true;
+    leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+    g_in_lookup = false;
+    if (!status.ok()) {
+        if (status.IsNotFound())
+            return false;
+        LogError("LevelDB read failure: %s", status.ToString());
+        HandleError(status);
+    }
+    return true;
+}
+
+void LevelDBEngine::Write(DBEngineBatch& batch, bool sync)
+{
+    leveldb::Status status = pdb->Write(sync ? syncoptions : writeoptions, &static_cast<LevelDBBatch&>(batch).batch);
+    HandleError(status);
+}
+
+std::unique_ptr<DBEngineIterator> LevelDBEngine::NewIterator() const
+{
+    return std::make_unique<LevelDBIterator>(pdb->NewIterator(iteroptions));
+}
+
+size_t LevelDBEngine::EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const
+{
+    leveldb::Slice slKey1(CharCast(begin.data()), begin.size());
+    leveldb::Slice slKey2(CharCast(end.data()), end.size());
+    uint64_t size = 0;
+    leveldb::Range range(slKey1, slKey2);
+    pdb->GetApproximateSizes(&range, 1, &size);
+    return size;
+}
+
+size_t LevelDBEngine::DynamicMemoryUsage() const
+{
+    std::string memory;
+    std::optional<size_t> parsed;
+    if (!pdb->GetProperty("leveldb.approximate-memory-usage", &memory) || !(parsed = ToIntegral<size_t>(memory))) {
+        LogDebug(BCLog::LEVELDB, "Failed to get approximate-memory-usage property\n");
+        return 0;
+    }
+    return parsed.value();
+}
+
+DBStats LevelDBEngine::GetStats() const
+{
+    DBStats stats;
+    std::string property;
+    // Files of each level, as lines like " 17:123['a' .. 'd']" (number:size) after "--- level 1 ---"
+    if (pdb->GetProperty("leveldb.sstables", &property)) {
+        for (const std::string& line : util::SplitString(property, '\n')) {
+            if (line.starts_with("--- level ")) {
+                stats.levels.emplace_back();
+            } else if (line.starts_with(' ') && !stats.levels.empty()) {
+                const size_t colon{line.find(':')}, bracket{line.find('[')};
+                if (colon == std::string::npos || bracket == std::string::npos || bracket < colon) continue;
+                ++stats.levels.back().files;
+                stats.levels.back().bytes += ToIntegral<uint64_t>(std::string_view{line}.substr(colon + 1, bracket - colon - 1)).value_or(0);
+            }
+        }
+    }
+    // Compactions into each level, as lines of "level files size(MB) time(sec) read(MB) write(MB)" in whole numbers
+    if (pdb->GetProperty("leveldb.stats", &property)) {
+        for (const std::string& line : util::SplitString(property, '\n')) {
+            std::vector<uint64_t> fields;
+            for (const std::string& field : util::SplitString(line, ' ')) {
+                if (field.empty()) continue;
+                const auto value{ToIntegral<uint64_t>(field)};
+                if (!value) break;
+                fields.push_back(*value);
+            }
+            if (fields.size() != 6 || fields[0] >= stats.levels.size()) continue;
+            DBStats::Level& level{stats.levels[fields[0]]};
+            level.compaction_seconds = fields[3];
+            level.compaction_read_bytes = fields[4] * 1_MiB;
+            level.compaction_written_bytes = fields[5] * 1_MiB;
+        }
+    }
+    stats.lookups = m_counters.lookups;
+    stats.lookup_file_reads = m_counters.lookup_file_reads;
+    if (options.filter_policy) {
+        stats.bloom_checks = m_counters.bloom_checks;
+        stats.bloom_rejections = m_counters.bloom_rejections;
+    }
+    stats.write_slowdowns = m_counters.write_slowdowns;
+    stats.write_stalls = m_counters.write_stalls;
+    stats.memory_usage = DynamicMemoryUsage();
+    return stats;
+}
+
+std::unique_ptr<DBEngine> OpenDBEngine(const DBParams& params)
+{
+    const DBEngineType engine{params.options.engine};
+    if (!params.memory_only && !params.testing_env) {
+        if (params.wipe_data) {
+            // Also remove the files of the other engine, so that wiping switches engines
+            if (engine == DBEngineType::LOGDB) {
+                LogInfo("Wiping LogDB in %s", fs::PathToString(params.path));
+                HandleError(leveldb::DestroyDB(fs::PathToString(params.path), {}));
+            }
+            if (!LogDB::Destroy(params.path)) {
+                throw dbwrapper_error(strprintf("Failed to wipe LogDB in %s", fs::PathToString(params.path)));
+            }
+        } else if (engine == DBEngineType::LOGDB ? fs::exists(params.path / "CURRENT") : LogDB::Exists(params.path)) {
+            throw dbwrapper_error(strprintf("The database in %s was not created with -dbengine=%s. "
+                                            "Use the previous -dbengine, or -reindex to rebuild the databases.",
+                                            fs::PathToString(params.path), DBEngineTypeToString(engine)));
+        }
+    }
+    switch (engine) {
+    case DBEngineType::LEVELDB: return std::make_unique<LevelDBEngine>(params);
+    case DBEngineType::LOGDB:
+        assert(!params.testing_env);
+        return std::make_unique<LogDB>(params.path, params.memory_only, params.options.max_file_size.value_or(params.max_file_size));
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+} // namespace
+
+std::optional<DBEngineType> DBEngineTypeFromString(std::string_view name)
+{
+    if (name == "leveldb") return DBEngineType::LEVELDB;
+    if (name == "logdb") return DBEngineType::LOGDB;
+    return std::nullopt;
+}
+
+std::string DBEngineTypeToString(DBEngineType engine)
+{
+    switch (engine) {
+    case DBEngineType::LEVELDB: return "leveldb";
+    case DBEngineType::LOGDB: return "logdb";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+CDBBatch::CDBBatch(const CDBWrapper& _parent)
+    : parent{_parent},
+      m_impl_batch{_parent.m_engine->NewBatch()}
+{
+    m_key_scratch.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+    m_value_scratch.reserve(DBWRAPPER_PREALLOC_VALUE_SIZE);
+    Clear();
+};
+
+CDBBatch::~CDBBatch() = default;
+
+void CDBBatch::Clear()
+{
+    m_impl_batch->Clear();
+    assert(m_key_scratch.empty());
+    assert(m_value_scratch.empty());
+}
+
+void CDBBatch::WriteImpl(std::span<const std::byte> key, DataStream& value)
+{
+    dbwrapper_private::GetObfuscation(parent)(value);
+    m_impl_batch->Put(key, value);
+}
+
+void CDBBatch::EraseImpl(std::span<const std::byte> key)
+{
+    m_impl_batch->Delete(key);
+}
+
+size_t CDBBatch::ApproximateSize() const
+{
+    return m_impl_batch->ApproximateSize();
+}
+
+CDBWrapper::CDBWrapper(const DBParams& params)
+    : m_engine{OpenDBEngine(params)}, m_name{fs::PathToString(params.path.stem())}
+{
     if (params.options.force_compact) {
         LogInfo("Starting database compaction of %s", fs::PathToString(params.path));
-        DBContext().pdb->CompactRange(nullptr, nullptr);
+        m_engine->CompactAll();
         LogInfo("Finished database compaction of %s", fs::PathToString(params.path));
     }
 
@@ -271,19 +611,7 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     LogInfo("Using obfuscation key for %s: %s", fs::PathToString(params.path), m_obfuscation.HexKey());
 }
 
-CDBWrapper::~CDBWrapper()
-{
-    delete DBContext().pdb;
-    DBContext().pdb = nullptr;
-    delete DBContext().options.filter_policy;
-    DBContext().options.filter_policy = nullptr;
-    delete DBContext().options.info_log;
-    DBContext().options.info_log = nullptr;
-    delete DBContext().options.block_cache;
-    DBContext().options.block_cache = nullptr;
-    delete DBContext().penv;
-    DBContext().options.env = nullptr;
-}
+CDBWrapper::~CDBWrapper() = default;
 
 void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 {
@@ -292,8 +620,7 @@ void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
     if (log_memory) {
         mem_before = DynamicMemoryUsage() / double(1_MiB);
     }
-    leveldb::Status status = DBContext().pdb->Write(fSync ? DBContext().syncoptions : DBContext().writeoptions, &batch.m_impl_batch->batch);
-    HandleError(status);
+    m_engine->Write(*batch.m_impl_batch, fSync);
     if (log_memory) {
         double mem_after{DynamicMemoryUsage() / double(1_MiB)};
         LogDebug(BCLog::LEVELDB, "WriteBatch memory usage: db=%s, before=%.1fMiB, after=%.1fMiB\n",
@@ -303,52 +630,27 @@ void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 
 size_t CDBWrapper::DynamicMemoryUsage() const
 {
-    std::string memory;
-    std::optional<size_t> parsed;
-    if (!DBContext().pdb->GetProperty("leveldb.approximate-memory-usage", &memory) || !(parsed = ToIntegral<size_t>(memory))) {
-        LogDebug(BCLog::LEVELDB, "Failed to get approximate-memory-usage property\n");
-        return 0;
-    }
-    return parsed.value();
+    return m_engine->DynamicMemoryUsage();
+}
+
+DBStats CDBWrapper::GetStats() const
+{
+    return m_engine->GetStats();
 }
 
 std::optional<std::string> CDBWrapper::ReadImpl(std::span<const std::byte> key) const
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
-    if (!status.ok()) {
-        if (status.IsNotFound())
-            return std::nullopt;
-        LogError("LevelDB read failure: %s", status.ToString());
-        HandleError(status);
-    }
-    return strValue;
+    return m_engine->Read(key);
 }
 
 bool CDBWrapper::ExistsImpl(std::span<const std::byte> key) const
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-
-    std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
-    if (!status.ok()) {
-        if (status.IsNotFound())
-            return false;
-        LogError("LevelDB read failure: %s", status.ToString());
-        HandleError(status);
-    }
-    return true;
+    return m_engine->Exists(key);
 }
 
 size_t CDBWrapper::EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const
 {
-    leveldb::Slice slKey1(CharCast(key1.data()), key1.size());
-    leveldb::Slice slKey2(CharCast(key2.data()), key2.size());
-    uint64_t size = 0;
-    leveldb::Range range(slKey1, slKey2);
-    DBContext().pdb->GetApproximateSizes(&range, 1, &size);
-    return size;
+    return m_engine->EstimateSize(key1, key2);
 }
 
 bool CDBWrapper::IsEmpty()
@@ -358,45 +660,38 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
-struct CDBIterator::IteratorImpl {
-    const std::unique_ptr<leveldb::Iterator> iter;
-
-    explicit IteratorImpl(leveldb::Iterator* _iter) : iter{_iter} {}
-};
-
-CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter) : parent(_parent),
-                                                                                            m_impl_iter(std::move(_piter))
+CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<DBEngineIterator> _piter) : parent(_parent),
+                                                                                               m_impl_iter(std::move(_piter))
 {
     m_scratch.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
 }
 
 CDBIterator* CDBWrapper::NewIterator()
 {
-    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
+    return new CDBIterator{*this, m_engine->NewIterator()};
 }
 
 void CDBIterator::SeekImpl(std::span<const std::byte> key)
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    m_impl_iter->iter->Seek(slKey);
+    m_impl_iter->Seek(key);
 }
 
 std::span<const std::byte> CDBIterator::GetKeyImpl() const
 {
     // The returned span borrows from the current iterator entry and is only
     // valid until the iterator is advanced.
-    return MakeByteSpan(m_impl_iter->iter->key());
+    return m_impl_iter->Key();
 }
 
 std::span<const std::byte> CDBIterator::GetValueImpl() const
 {
-    return MakeByteSpan(m_impl_iter->iter->value());
+    return m_impl_iter->Value();
 }
 
 CDBIterator::~CDBIterator() = default;
-bool CDBIterator::Valid() const { return m_impl_iter->iter->Valid(); }
-void CDBIterator::SeekToFirst() { m_impl_iter->iter->SeekToFirst(); }
-void CDBIterator::Next() { m_impl_iter->iter->Next(); }
+bool CDBIterator::Valid() const { return m_impl_iter->Valid(); }
+void CDBIterator::SeekToFirst() { m_impl_iter->SeekToFirst(); }
+void CDBIterator::Next() { m_impl_iter->Next(); }
 
 namespace dbwrapper_private {
 
@@ -5,7 +5,7 @@
 #ifndef BITCOIN_DBWRAPPER_H
 #define BITCOIN_DBWRAPPER_H
 
-#include <attributes.h>
+#include <dbengine.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
@@ -19,6 +19,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace leveldb {
 class Env;
@@ -27,20 +28,42 @@ class Env;
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 static const size_t DBWRAPPER_MAX_FILE_SIZE{32_MiB};
+static const int DEFAULT_DB_BLOOM_BITS{10};
+
+enum class DBEngineType {
+    LEVELDB,
+    //! See LogDB
+    LOGDB,
+};
+
+static constexpr DBEngineType DEFAULT_DB_ENGINE{DBEngineType::LEVELDB};
 
 //! User-controlled performance and debug options.
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Storage engine below the database.
+    DBEngineType engine = DEFAULT_DB_ENGINE;
+    //! Bits per key of the LevelDB bloom filters, 0 to disable them.
+    int bloom_bits = DEFAULT_DB_BLOOM_BITS;
+    //! Overrides of the LevelDB write buffer and block cache sizes, which are
+    //! otherwise shares of DBParams::cache_bytes.
+    std::optional<size_t> write_buffer_size{};
+    std::optional<size_t> block_cache_size{};
+    //! Override of DBParams::max_file_size.
+    std::optional<size_t> max_file_size{};
 };
 
+std::optional<DBEngineType> DBEngineTypeFromString(std::string_view name);
+std::string DBEngineTypeToString(DBEngineType engine);
+
 //! Application-specific storage settings.
 struct DBParams {
-    //! Location in the filesystem where leveldb data will be stored.
+    //! Location in the filesystem where the data will be stored.
     fs::path path;
     //! Configures various leveldb cache settings.
     size_t cache_bytes;
-    //! If true, use leveldb's memory environment.
+    //! If true, keep the data in memory.
     bool memory_only = false;
     //! If true, remove all existing data.
     bool wipe_data = false;
@@ -52,8 +75,8 @@ struct DBParams {
     //! If non-null, use this as the leveldb::Env instead of the default.
     //! Caller retains ownership.
     leveldb::Env* testing_env = nullptr;
-    //! Maximum LevelDB SST file size. Larger values reduce the frequency
-    //! of compactions but increase their duration.
+    //! Maximum LevelDB SST file size, or LogDB segment size. Larger values
+    //! reduce the frequency of compactions but increase their duration.
     size_t max_file_size = DBWRAPPER_MAX_FILE_SIZE;
 };
 
@@ -76,6 +99,7 @@ namespace dbwrapper_private {
 const Obfuscation& GetObfuscation(const CDBWrapper&);
 }; // namespace dbwrapper_private
 
+//! Remove the files of the database in the directory, whatever its engine.
 bool DestroyDB(const std::string& path_str);
 
 /** Batch of changes queued to be written to a CDBWrapper */
@@ -86,8 +110,7 @@ class CDBBatch
 private:
     const CDBWrapper &parent;
 
-    struct WriteBatchImpl;
-    const std::unique_ptr<WriteBatchImpl> m_impl_batch;
+    const std::unique_ptr<DBEngineBatch> m_impl_batch;
 
     DataStream m_key_scratch{};
     DataStream m_value_scratch{};
@@ -125,12 +148,9 @@ public:
 
 class CDBIterator
 {
-public:
-    struct IteratorImpl;
-
 private:
     const CDBWrapper &parent;
-    const std::unique_ptr<IteratorImpl> m_impl_iter;
+    const std::unique_ptr<DBEngineIterator> m_impl_iter;
     DataStream m_scratch{};
 
     void SeekImpl(std::span<const std::byte> key);
@@ -141,9 +161,9 @@ public:
 
     /**
      * @param[in] _parent          Parent CDBWrapper instance.
-     * @param[in] _piter           The original leveldb iterator.
+     * @param[in] _piter           The iterator of the storage engine.
      */
-    CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter);
+    CDBIterator(const CDBWrapper& _parent, std::unique_ptr<DBEngineIterator> _piter);
     ~CDBIterator();
 
     bool Valid() const;
@@ -181,14 +201,13 @@ public:
     }
 };
 
-struct LevelDBContext;
-
 class CDBWrapper
 {
+    friend class CDBBatch;
     friend const Obfuscation& dbwrapper_private::GetObfuscation(const CDBWrapper&);
 private:
-    //! holds all leveldb-specific fields of this class
-    std::unique_ptr<LevelDBContext> m_db_context;
+    //! the storage engine, which holds all its specific fields
+    const std::unique_ptr<DBEngine> m_engine;
 
     //! the name of this database
     std::string m_name;
@@ -202,7 +221,6 @@ private:
     std::optional<std::string> ReadImpl(std::span<const std::byte> key) const;
     bool ExistsImpl(std::span<const std::byte> key) const;
     size_t EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const;
-    auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
 
 public:
     CDBWrapper(const DBParams& params);
@@ -258,9 +276,11 @@ public:
 
     void WriteBatch(CDBBatch& batch, bool fSync = false);
 
-    // Get an estimate of LevelDB memory usage (in bytes).
+    // Get an estimate of the storage engine memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    DBStats GetStats() const;
+
     CDBIterator* NewIterator();
 
     /**
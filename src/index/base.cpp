@@ -11,6 +11,7 @@
 #include <interfaces/types.h>
 #include <kernel/types.h>
 #include <node/abort.h>
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/database_args.h>
@@ -72,7 +73,11 @@ BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool
         .memory_only = f_memory,
         .wipe_data = f_wipe,
         .obfuscate = f_obfuscate,
-        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }()}}
+        .options = [] {
+            DBOptions options;
+            Assert(node::ReadDatabaseArgs(gArgs, options, "indexes")); // no error can happen, already checked in AppInitParameterInteraction
+            return options;
+        }()}}
 {}
 
 CBlockLocator BaseIndex::DB::ReadBestBlock() const
@@ -208,6 +213,8 @@ void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
+        node::BlockPrefetcher prefetcher{m_chainstate->m_blockman};
+        const auto next_block{[this](const CBlockIndex& block) { return WITH_LOCK(cs_main, return m_chainstate->m_chain.Next(block)); }};
         auto last_log_time{NodeClock::now()};
         auto last_locator_write_time{last_log_time};
         while (true) {
@@ -249,7 +256,9 @@ void BaseIndex::Sync()
             pindex = pindex_next;
 
 
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            // A failed read is retried by ProcessBlock, which logs the error
+            const std::shared_ptr<const CBlock> block{prefetcher.Read(*pindex, next_block)};
+            if (!ProcessBlock(pindex, block.get())) return; // error logged internally
 
             auto current_time{NodeClock::now()};
             if (current_time - last_log_time >= SYNC_LOG_INTERVAL) {
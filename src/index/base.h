@@ -180,6 +180,9 @@ public:
 
     /// Get a summary of the index and its state.
     IndexSummary GetSummary() const;
+
+    /// Get the statistics of the index database.
+    DBStats GetDBStats() const { return GetDB().GetStats(); }
 };
 
 #endif // BITCOIN_INDEX_BASE_H
@@ -80,6 +80,19 @@ public:
     mutable bool found = false;
 };
 
+//! Reader of the blocks of a scan along the active chain. While the caller
+//! processes a block, the blocks following it in the active chain are read on
+//! background threads.
+class BlockReader
+{
+public:
+    virtual ~BlockReader() = default;
+
+    //! Read block data from disk, or return nullptr if the block is not known
+    //! or does not have data (for example due to pruning).
+    virtual std::shared_ptr<const CBlock> readBlock(const uint256& hash) = 0;
+};
+
 //! The action to be taken after updating a settings value.
 //! WRITE indicates that the updated value must be written to disk,
 //! while SKIP_WRITE indicates that the change will be kept in memory-only
@@ -148,6 +161,10 @@ public:
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
 
+    //! Return a reader for a scan reading the blocks of the active chain in
+    //! order, which reads ahead the following ones.
+    virtual std::unique_ptr<BlockReader> makeBlockReader() = 0;
+
     //! Find first block in the chain with timestamp >= the given time
     //! and height >= than the given height, return false if there is no block
     //! with a high enough timestamp and height. Optionally return block
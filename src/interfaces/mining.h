@@ -57,7 +57,10 @@ public:
      *
      * @param[in] version version block header field
      * @param[in] timestamp time block header field (unix timestamp)
-     * @param[in] nonce nonce block header field
+     * @param[in] nonce nonce block header field, the full 256 bits encoding the
+     *                  PoW version, the nBits offset and the prime constellation
+     *                  offset, so solutions for a retained template can be
+     *                  submitted without re-sending its transactions
      * @param[in] coinbase complete coinbase transaction (including witness)
      *
      * @note Unlike the submitblock RPC, this method does not call
@@ -75,7 +78,7 @@ public:
      *       the solved block is constructed and broadcast by multiple nodes
      *       (e.g. both the miner who constructed the template and the pool).
      */
-    virtual bool submitSolution(uint32_t version, uint32_t timestamp, uint32_t nonce, CTransactionRef coinbase) = 0;
+    virtual bool submitSolution(uint32_t version, uint32_t timestamp, const uint256& nonce, CTransactionRef coinbase) = 0;
 
     /**
      * Waits for fees in the next block to rise, a new tip or the timeout.
@@ -16,6 +16,7 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+static constexpr bool DEFAULT_BLOCKS_MMAP{false};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -24,6 +25,8 @@ static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
 struct BlockManagerOpts {
     const CChainParams& chainparams;
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
+    //! Read the block files through memory mappings (not supported on Windows and 32 bit platforms)
+    bool use_mmap{DEFAULT_BLOCKS_MMAP};
     uint64_t prune_target{0};
     bool fast_prune{false};
     const fs::path blocks_dir;
@@ -17,6 +17,7 @@
 #include <util/hash_type.h>
 #include <util/vector.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -34,22 +35,70 @@ struct CheckpointData {
     int assumedValidBlockHeight;
 
     bool isKnownHeaderBatch(std::span<const CBlockHeader> headers, const uint32_t start) const {
-        DataStream headersSerialized{};
+        if (start > static_cast<uint32_t>(assumedValidBlockHeight))
+            return false;
+        HashWriter hasher{};
         for (const CBlockHeader& header : headers)
-            headersSerialized << header;
-        const auto hashIt(knownHeaderBatchesHashes.find(Hash(headersSerialized)));
+            hasher << header;
+        const auto hashIt(knownHeaderBatchesHashes.find(hasher.GetHash()));
         if (hashIt != knownHeaderBatchesHashes.end())
             return std::make_pair(start, static_cast<uint32_t>(headers.size())) == hashIt->second;
         return false;
     }
+
+    /** Start Height of the Known Header Batch containing the Header at the given Height, if any. */
+    std::optional<uint32_t> getHeaderBatchStart(const uint32_t height) const {
+        if (height > static_cast<uint32_t>(assumedValidBlockHeight))
+            return {};
+        for (const auto& [hash, batch] : knownHeaderBatchesHashes) {
+            if (height >= batch.first && height - batch.first < batch.second)
+                return batch.first;
+        }
+        return {};
+    }
+
+    /**
+     * Number of leading Headers that belong to Known Header Batches, the first one being at Height start, which does not need to be the start of a Batch.
+     * The concatenated Headers are hashed incrementally Batch by Batch, and a Batch is only recognized once complete, so previousHeaders must hold the Headers from the start of the Batch containing headers[0] (see getHeaderBatchStart) up to it.
+     */
+    size_t countKnownHeaders(std::span<const CBlockHeader> previousHeaders, std::span<const CBlockHeader> headers, const uint32_t start) const {
+        if (previousHeaders.size() >= start)
+            return 0;
+        uint32_t batchStart(start - previousHeaders.size());
+        size_t knownHeaders(0);
+        while (knownHeaders < headers.size() && batchStart <= static_cast<uint32_t>(assumedValidBlockHeight)) {
+            const auto batchIt(std::find_if(knownHeaderBatchesHashes.begin(), knownHeaderBatchesHashes.end(), [batchStart](const auto& batch) {return batch.second.first == batchStart;}));
+            if (batchIt == knownHeaderBatchesHashes.end())
+                break;
+            const size_t batchEnd(batchStart + batchIt->second.second - start); // Index in headers of the first Header after the Batch
+            if (batchEnd > headers.size())
+                break;
+            HashWriter hasher{};
+            if (knownHeaders == 0) {
+                for (const CBlockHeader& header : previousHeaders)
+                    hasher << header;
+            }
+            for (size_t i(knownHeaders) ; i < batchEnd ; i++)
+                hasher << headers[i];
+            if (hasher.GetHash() != batchIt->first)
+                break;
+            knownHeaders = batchEnd;
+            batchStart += batchIt->second.second;
+        }
+        return knownHeaders;
+    }
 };
 
 struct Blacklist {
-    /** Known Scammer or other High Risk Scripts. */
+    /** Known Scammer or other High Risk Scripts. Sorted as this is looked up for every spent Coin. */
     std::vector<CScript> disabledScripts;
 
-    bool isDisabled(const CScript script) const {
-        return std::find(disabledScripts.begin(), disabledScripts.end(), script) != disabledScripts.end();
+    explicit Blacklist(std::vector<CScript> scripts) : disabledScripts{std::move(scripts)} {
+        std::sort(disabledScripts.begin(), disabledScripts.end());
+    }
+
+    bool isDisabled(const CScript& script) const {
+        return std::binary_search(disabledScripts.begin(), disabledScripts.end(), script);
     }
 };
 
@@ -20,6 +20,7 @@
 #include <logging.h>
 #include <node/blockstorage.h>
 #include <node/chainstate.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <script/interpreter.h>
@@ -35,10 +36,12 @@
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/task_runner.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <exception>
@@ -482,6 +485,55 @@ struct ChainMan {
         : m_chainman(std::move(chainman)), m_context(std::move(context)) {}
 };
 
+class HeaderPoWVerifier
+{
+private:
+    ThreadPool m_pool{"headerpow"};
+    const unsigned int m_num_threads;
+
+public:
+    explicit HeaderPoWVerifier(unsigned int num_threads) : m_num_threads{num_threads}
+    {
+        if (m_num_threads > 0) m_pool.Start(m_num_threads);
+    }
+
+    size_t Verify(const Consensus::Params& params, std::span<const std::byte> raw_headers, std::span<int> results)
+    {
+        const auto verify_range{[&params, raw_headers, results](size_t begin, size_t end) {
+            size_t valid{0};
+            for (size_t i{begin}; i < end; ++i) {
+                CBlockHeader header;
+                SpanReader stream{raw_headers.subspan(i * btck_BLOCK_HEADER_SERIALIZED_SIZE, btck_BLOCK_HEADER_SERIALIZED_SIZE)};
+                try {
+                    stream >> header;
+                } catch (...) {
+                    results[i] = 0;
+                    continue;
+                }
+                results[i] = CheckProofOfWork(header.GetHashForPoW(), header.nBits, ArithToUint256(header.nNonce), params) ? 1 : 0;
+                valid += results[i];
+            }
+            return valid;
+        }};
+        // The cost of a check varies a lot from a header to another, so use a few chunks per thread to balance the load
+        const size_t num_chunks{std::min<size_t>(results.size(), (m_num_threads + 1) * 4)};
+        if (m_num_threads == 0 || num_chunks <= 1) return verify_range(0, results.size());
+
+        std::vector<std::function<size_t()>> tasks;
+        tasks.reserve(num_chunks);
+        for (size_t chunk{0}; chunk < num_chunks; ++chunk) {
+            tasks.emplace_back([&verify_range, begin{chunk * results.size() / num_chunks}, end{(chunk + 1) * results.size() / num_chunks}] { return verify_range(begin, end); });
+        }
+        auto futures{m_pool.Submit(std::move(tasks))};
+        if (!futures) return verify_range(0, results.size());
+        // Take part in the verification instead of idly waiting for the workers
+        while (m_pool.ProcessTask()) {}
+        size_t valid{0};
+        for (auto& future : *futures) valid += future.get();
+        return valid;
+    }
+};
+
 } // namespace
 
 struct btck_Transaction : Handle<btck_Transaction, std::shared_ptr<const CTransaction>> {};
@@ -504,6 +556,7 @@ struct btck_Txid: Handle<btck_Txid, Txid> {};
 struct btck_PrecomputedTransactionData : Handle<btck_PrecomputedTransactionData, PrecomputedTransactionData> {};
 struct btck_BlockHeader: Handle<btck_BlockHeader, CBlockHeader> {};
 struct btck_ConsensusParams: Handle<btck_ConsensusParams, Consensus::Params> {};
+struct btck_HeaderPoWVerifier: Handle<btck_HeaderPoWVerifier, HeaderPoWVerifier> {};
 
 btck_Transaction* btck_transaction_create(const void* raw_transaction, size_t raw_transaction_len)
 {
@@ -1445,6 +1498,30 @@ void btck_block_header_destroy(btck_BlockHeader* header)
     delete header;
 }
 
+btck_HeaderPoWVerifier* btck_header_pow_verifier_create(unsigned int num_threads)
+{
+    try {
+        return btck_HeaderPoWVerifier::create(num_threads);
+    } catch (const std::exception& e) {
+        LogError("Failed to start the header PoW verifier threads: %s", e.what());
+        return nullptr;
+    }
+}
+
+size_t btck_header_pow_verifier_verify(btck_HeaderPoWVerifier* verifier, const btck_ConsensusParams* consensus_params, const void* raw_block_headers, size_t num_headers, int* results)
+{
+    if (num_headers == 0) return 0;
+    assert(raw_block_headers != nullptr && results != nullptr);
+    return btck_HeaderPoWVerifier::get(verifier).Verify(btck_ConsensusParams::get(consensus_params),
+                                                         std::span{reinterpret_cast<const std::byte*>(raw_block_headers), num_headers * btck_BLOCK_HEADER_SERIALIZED_SIZE},
+                                                         std::span{results, num_headers});
+}
+
+void btck_header_pow_verifier_destroy(btck_HeaderPoWVerifier* verifier)
+{
+    delete verifier;
+}
+
 btck_ValidationMode btck_tx_validation_state_get_validation_mode(const btck_TxValidationState* state_)
 {
     const auto& state = btck_TxValidationState::get(state_);
@@ -331,6 +331,13 @@ typedef struct btck_Txid btck_Txid;
  */
 typedef struct btck_BlockHeader btck_BlockHeader;
 
+/**
+ * Opaque data structure for holding a pool of threads verifying the proof of
+ * work of block headers in batches. The threads are kept alive for the
+ * lifetime of the verifier, so that it can be reused for many batches.
+ */
+typedef struct btck_HeaderPoWVerifier btck_HeaderPoWVerifier;
+
 /** Current sync state passed to tip changed callbacks. */
 typedef uint8_t btck_SynchronizationState;
 #define btck_SynchronizationState_INIT_REINDEX ((btck_SynchronizationState)(0))
@@ -1969,6 +1976,56 @@ BITCOINKERNEL_API void btck_block_header_destroy(btck_BlockHeader* header);
 
 ///@}
 
+/**
+ * @name Header PoW Verifier
+ * Functions for verifying the proof of work of many block headers at once.
+ */
+///@{
+
+/** Size of a serialized block header, as expected by btck_header_pow_verifier_verify. */
+#define btck_BLOCK_HEADER_SERIALIZED_SIZE 112
+
+/**
+ * @brief Create a btck_HeaderPoWVerifier.
+ *
+ * @param[in] num_threads Number of worker threads to start. The calling thread
+ *                        of btck_header_pow_verifier_verify also takes part in
+ *                        the verification, so 0 verifies everything on it.
+ * @return                The btck_HeaderPoWVerifier, or null on error.
+ */
+BITCOINKERNEL_API btck_HeaderPoWVerifier* BITCOINKERNEL_WARN_UNUSED_RESULT btck_header_pow_verifier_create(
+    unsigned int num_threads);
+
+/**
+ * @brief Verify the proof of work of a batch of serialized block headers. Only
+ * the proof of work is checked: each header is verified on its own, so the
+ * results do not depend on the order of the headers nor on whether they
+ * connect to each other. The work is spread over the threads of the verifier.
+ *
+ * @param[in]  verifier          Non-null.
+ * @param[in]  consensus_params  Non-null, btck_ConsensusParams for validation.
+ * @param[in]  raw_block_headers Serialized headers of btck_BLOCK_HEADER_SERIALIZED_SIZE
+ *                               bytes each, concatenated. Non-null unless num_headers is 0.
+ * @param[in]  num_headers       Number of headers in raw_block_headers.
+ * @param[out] results           Array of num_headers entries, set to 1 for each header
+ *                               with a valid proof of work and to 0 otherwise.
+ *                               Non-null unless num_headers is 0.
+ * @return                       The number of headers with a valid proof of work.
+ */
+BITCOINKERNEL_API size_t btck_header_pow_verifier_verify(
+    btck_HeaderPoWVerifier* verifier,
+    const btck_ConsensusParams* consensus_params,
+    const void* raw_block_headers,
+    size_t num_headers,
+    int* results) BITCOINKERNEL_ARG_NONNULL(1, 2);
+
+/**
+ * Destroy the btck_HeaderPoWVerifier, stopping its threads.
+ */
+BITCOINKERNEL_API void btck_header_pow_verifier_destroy(btck_HeaderPoWVerifier* verifier);
+
+///@}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
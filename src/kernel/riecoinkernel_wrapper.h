@@ -1020,6 +1020,23 @@ inline bool Block::Check(const ConsensusParamsView& consensus_params,
     return btck_block_check(get(), consensus_params.get(), static_cast<btck_BlockCheckFlags>(flags), state.get()) == 1;
 }
 
+class HeaderPoWVerifier : public UniqueHandle<btck_HeaderPoWVerifier, btck_header_pow_verifier_destroy>
+{
+public:
+    explicit HeaderPoWVerifier(unsigned int num_threads) : UniqueHandle{btck_header_pow_verifier_create(num_threads)} {}
+
+    /** Verify the proof of work of concatenated serialized headers, returning whether each one is valid. */
+    std::vector<bool> Verify(const ConsensusParamsView& consensus_params, std::span<const std::byte> raw_headers)
+    {
+        if (raw_headers.size() % btck_BLOCK_HEADER_SERIALIZED_SIZE != 0) {
+            throw std::invalid_argument("Serialized headers size is not a multiple of the header size");
+        }
+        std::vector<int> results(raw_headers.size() / btck_BLOCK_HEADER_SERIALIZED_SIZE);
+        btck_header_pow_verifier_verify(get(), consensus_params.get(), raw_headers.data(), results.size(), results.data());
+        return {results.begin(), results.end()};
+    }
+};
+
 class TxValidationState : public UniqueHandle<btck_TxValidationState, btck_tx_validation_state_destroy>
 {
 public:
@@ -0,0 +1,860 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <logdb.h>
+
+#include <crc32c/crc32c.h>
+#include <crypto/common.h>
+#include <crypto/siphash.h>
+#include <dbwrapper.h>
+#include <memusage.h>
+#include <random.h>
+#include <span.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/fs_helpers.h>
+#include <util/log.h>
+#include <util/strencodings.h>
+#include <util/thread.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+//! Size and checksum of the payload of a frame
+constexpr size_t FRAME_HEADER_SIZE{8};
+
+enum class Op : uint8_t {
+    ERASE = 0,
+    WRITE = 1,
+};
+
+//! Entry of a frame payload, serialized as the op, the key size and the key, then for writes the value size and the value
+struct Entry {
+    Op op{Op::ERASE};
+    std::span<const std::byte> key;
+    std::span<const std::byte> value;
+    //! Offset of the value in the payload
+    size_t value_offset{0};
+};
+
+size_t EntrySize(Op op, size_t key_size, size_t value_size = 0)
+{
+    return 1 + 4 + key_size + (op == Op::WRITE ? 4 + value_size : 0);
+}
+
+//! Parse the entry at pos of a payload, and move pos to the next one.
+Entry ParseEntry(std::span<const std::byte> payload, size_t& pos)
+{
+    const auto take{[&](size_t size) {
+        if (payload.size() - pos < size) throw dbwrapper_error("Malformed LogDB frame");
+        const auto data{payload.subspan(pos, size)};
+        pos += size;
+        return data;
+    }};
+    Entry entry;
+    entry.op = Op{std::to_integer<uint8_t>(take(1)[0])};
+    if (entry.op != Op::ERASE && entry.op != Op::WRITE) throw dbwrapper_error("Malformed LogDB frame");
+    entry.key = take(ReadLE32(take(4).data()));
+    if (entry.op == Op::WRITE) {
+        const uint32_t size{ReadLE32(take(4).data())};
+        entry.value_offset = pos;
+        entry.value = take(size);
+    }
+    return entry;
+}
+
+std::string SegmentFilename(uint32_t id) { return strprintf("%06u.seg", id); }
+
+std::optional<uint32_t> ParseSegmentFilename(std::string_view filename)
+{
+    if (filename.size() != 10 || !filename.ends_with(".seg")) return std::nullopt;
+    return ToIntegral<uint32_t>(filename.substr(0, 6));
+}
+
+std::string KeyString(std::span<const std::byte> key) { return {reinterpret_cast<const char*>(key.data()), key.size()}; }
+} // namespace
+
+namespace {
+/**
+ * Segments whose file is open, over all the databases, so that they do not exhaust the file descriptors.
+ * Past LogDB::MAX_OPEN_FILES, the least recently used ones, as approximated by a clock, are closed until
+ * their next access.
+ */
+class OpenSegmentFiles
+{
+public:
+    //! Record the opening of the file of a segment, and return the segments whose file must be closed, which the
+    //! caller does once it holds no segment lock.
+    std::vector<std::shared_ptr<LogDB::Segment>> Add(std::weak_ptr<LogDB::Segment> segment, std::shared_ptr<std::atomic<bool>> used) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<std::shared_ptr<LogDB::Segment>> evicted;
+        LOCK(m_mutex);
+        // The destroyed segments closed their file
+        std::erase_if(m_slots, [](const Slot& slot) { return slot.segment.expired(); });
+        while (m_slots.size() >= LogDB::MAX_OPEN_FILES) {
+            if (m_hand >= m_slots.size()) m_hand = 0;
+            Slot& slot{m_slots[m_hand]};
+            // The segments used since the hand last passed get another chance
+            if (slot.used->exchange(false, std::memory_order_relaxed)) {
+                ++m_hand;
+                continue;
+            }
+            if (auto evicted_segment{slot.segment.lock()}) evicted.push_back(std::move(evicted_segment));
+            m_slots.erase(m_slots.begin() + m_hand);
+        }
+        m_slots.push_back({std::move(segment), std::move(used)});
+        return evicted;
+    }
+
+    size_t Count() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return std::ranges::count_if(m_slots, [](const Slot& slot) { return !slot.segment.expired(); });
+    }
+
+private:
+    struct Slot {
+        std::weak_ptr<LogDB::Segment> segment;
+        //! Shared with the segment, so that it can be read without keeping the latter alive
+        std::shared_ptr<std::atomic<bool>> used;
+    };
+
+    mutable Mutex m_mutex;
+    std::vector<Slot> m_slots GUARDED_BY(m_mutex);
+    size_t m_hand GUARDED_BY(m_mutex){0};
+};
+
+OpenSegmentFiles g_open_segment_files;
+} // namespace
+
+/** File of the log, or buffer when the database is in memory. The file is opened on access, and may be closed between them. */
+class LogDB::Segment : public std::enable_shared_from_this<LogDB::Segment>
+{
+public:
+    const uint32_t m_id;
+    //! Empty when the segment is in memory
+    const fs::path m_path;
+    //! Bytes of the live writes and of the erasures in the segment, only accessed with the write mutex of the database held
+    uint64_t m_live_bytes{0};
+    uint64_t m_erase_bytes{0};
+
+    Segment(uint32_t id, fs::path path) : m_id{id}, m_path{std::move(path)}
+    {
+        if (m_path.empty()) return;
+        FILE* file{fsbridge::fopen(m_path, "a+b")};
+        if (!file || std::fseek(file, 0, SEEK_END) != 0) {
+            if (file) std::fclose(file);
+            throw dbwrapper_error(strprintf("Failed to open LogDB segment %s", fs::PathToString(m_path)));
+        }
+        LOCK(m_mutex);
+        m_size = std::ftell(file);
+        std::fclose(file);
+    }
+
+    ~Segment()
+    {
+        LOCK(m_mutex);
+        if (m_file) std::fclose(m_file);
+        if (m_obsolete) {
+            std::error_code error;
+            fs::remove(m_path, error);
+            if (error) LogWarning("Failed to remove LogDB segment %s: %s", fs::PathToString(m_path), error.message());
+        }
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    uint64_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return m_size;
+    }
+
+    void Append(std::span<const std::byte> data, bool sync) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        EvictedFiles evicted;
+        LOCK(m_mutex);
+        if (m_path.empty()) {
+            m_data.insert(m_data.end(), data.begin(), data.end());
+        } else if (FILE* file{OpenFile(evicted)}; std::fseek(file, 0, SEEK_END) != 0 || std::fwrite(data.data(), 1, data.size(), file) != data.size() || std::fflush(file) != 0 || (sync && !FileCommit(file))) {
+            // Do not leave a partial frame, which would hide the next ones
+            std::clearerr(file);
+            TruncateFile(file, m_size);
+            throw dbwrapper_error(strprintf("Failed to write to LogDB segment %s", fs::PathToString(m_path)));
+        }
+        m_size += data.size();
+    }
+
+    void Sync() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        EvictedFiles evicted;
+        LOCK(m_mutex);
+        if (!m_path.empty() && !FileCommit(OpenFile(evicted))) throw dbwrapper_error(strprintf("Failed to sync LogDB segment %s", fs::PathToString(m_path)));
+    }
+
+    void Read(uint64_t offset, std::span<std::byte> data) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        EvictedFiles evicted;
+        LOCK(m_mutex);
+        if (offset > m_size || m_size - offset < data.size()) {
+            throw dbwrapper_error(strprintf("Out of bounds read from LogDB segment %s", fs::PathToString(m_path)));
+        }
+        if (m_path.empty()) {
+            std::copy_n(m_data.begin() + offset, data.size(), data.begin());
+        } else if (FILE* file{OpenFile(evicted)}; std::fseek(file, offset, SEEK_SET) != 0 || std::fread(data.data(), 1, data.size(), file) != data.size()) {
+            std::clearerr(file);
+            throw dbwrapper_error(strprintf("Failed to read from LogDB segment %s", fs::PathToString(m_path)));
+        }
+    }
+
+    std::vector<std::byte> ReadAll() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<std::byte> data(Size());
+        Read(0, data);
+        return data;
+    }
+
+    void Truncate(uint64_t size) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        EvictedFiles evicted;
+        LOCK(m_mutex);
+        if (m_path.empty()) {
+            m_data.resize(size);
+        } else if (FILE* file{OpenFile(evicted)}; std::fflush(file) != 0 || !TruncateFile(file, size)) {
+            throw dbwrapper_error(strprintf("Failed to truncate LogDB segment %s", fs::PathToString(m_path)));
+        }
+        m_size = size;
+    }
+
+    //! Remove the file once the last reader of the segment is done with it.
+    void MarkObsolete() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_obsolete = !m_path.empty();
+    }
+
+    //! Close the file, to be reopened on the next access.
+    void CloseFile() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (m_file) std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+private:
+    /** Segments whose file is closed when this goes out of scope, after the segment lock taken after it is released */
+    struct EvictedFiles {
+        std::vector<std::shared_ptr<Segment>> segments;
+
+        ~EvictedFiles()
+        {
+            for (const auto& segment : segments) segment->CloseFile();
+        }
+    };
+
+    FILE* OpenFile(EvictedFiles& evicted) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        m_used->store(true, std::memory_order_relaxed);
+        if (!m_file) {
+            m_file = fsbridge::fopen(m_path, "a+b");
+            if (!m_file) throw dbwrapper_error(strprintf("Failed to open LogDB segment %s", fs::PathToString(m_path)));
+            evicted.segments = g_open_segment_files.Add(weak_from_this(), m_used);
+        }
+        return m_file;
+    }
+
+    mutable Mutex m_mutex;
+    FILE* m_file GUARDED_BY(m_mutex){nullptr};
+    //! Whether the file was accessed since the clock of the open files last passed
+    const std::shared_ptr<std::atomic<bool>> m_used{std::make_shared<std::atomic<bool>>(true)};
+    std::vector<std::byte> m_data GUARDED_BY(m_mutex);
+    uint64_t m_size GUARDED_BY(m_mutex){0};
+    bool m_obsolete GUARDED_BY(m_mutex){false};
+};
+
+/** Frame being built, with room for its header before the payload. */
+class LogDB::Batch final : public DBEngineBatch
+{
+public:
+    std::vector<std::byte> m_frame;
+
+    Batch() { Clear(); }
+
+    void Put(std::span<const std::byte> key, std::span<const std::byte> value) override
+    {
+        AppendKey(Op::WRITE, key);
+        AppendSize(value.size());
+        m_frame.insert(m_frame.end(), value.begin(), value.end());
+    }
+
+    void Delete(std::span<const std::byte> key) override { AppendKey(Op::ERASE, key); }
+    void Clear() override { m_frame.assign(FRAME_HEADER_SIZE, std::byte{0}); }
+    size_t ApproximateSize() const override { return m_frame.size(); }
+    bool Empty() const { return m_frame.size() == FRAME_HEADER_SIZE; }
+
+private:
+    void AppendSize(size_t size)
+    {
+        std::array<std::byte, 4> data;
+        WriteLE32(data.data(), size);
+        m_frame.insert(m_frame.end(), data.begin(), data.end());
+    }
+
+    void AppendKey(Op op, std::span<const std::byte> key)
+    {
+        m_frame.push_back(std::byte{static_cast<uint8_t>(op)});
+        AppendSize(key.size());
+        m_frame.insert(m_frame.end(), key.begin(), key.end());
+    }
+};
+
+/**
+ * Merges the partitions of the index, each contributing a window of its entries from the position, which is
+ * refilled from the last key taken once consumed. So positioning does not copy the index, and does not hold
+ * its locks but to fill the windows. These start small, as a seek is often followed by only a few steps, and
+ * grow as the partition is iterated.
+ */
+class LogDB::Iterator final : public DBEngineIterator
+{
+public:
+    explicit Iterator(const LogDB& db) : m_db{db} {}
+
+    bool Valid() const override { return !m_heap.empty(); }
+    void SeekToFirst() override { Seek({}); }
+
+    void Seek(std::span<const std::byte> key) override
+    {
+        const std::string start{KeyString(key)};
+        m_heap.clear();
+        for (size_t partition{0}; partition < PARTITIONS; ++partition) {
+            m_windows[partition].size = MIN_WINDOW_SIZE;
+            Fill(partition, start, /*inclusive=*/true);
+        }
+        ReadValue();
+    }
+
+    void Next() override
+    {
+        Step();
+        ReadValue();
+    }
+
+    std::span<const std::byte> Key() const override { return MakeByteSpan(Current().first); }
+    std::span<const std::byte> Value() const override { return m_value; }
+
+private:
+    using Entry = std::pair<std::string, Location>;
+
+    //! Entries of a partition from the position
+    struct Window {
+        std::vector<Entry> entries;
+        size_t pos{0};
+        //! Number of entries of the next fill
+        size_t size{0};
+    };
+
+    static constexpr size_t MIN_WINDOW_SIZE{2};
+    static constexpr size_t MAX_WINDOW_SIZE{64};
+
+    const Entry& Current() const { return m_windows[m_heap.front()].entries[m_windows[m_heap.front()].pos]; }
+    Entry& Current() { return m_windows[m_heap.front()].entries[m_windows[m_heap.front()].pos]; }
+
+    //! Min-heap order of the partitions by their current key
+    bool Greater(size_t a, size_t b) const
+    {
+        return m_windows[a].entries[m_windows[a].pos].first > m_windows[b].entries[m_windows[b].pos].first;
+    }
+
+    //! Fill the window of a partition with its entries from a key, and add the partition to the heap if there are some.
+    void Fill(size_t partition, const std::string& from, bool inclusive)
+    {
+        Window& window{m_windows[partition]};
+        window.entries.clear();
+        window.pos = 0;
+        {
+            const Partition& source{*m_db.m_partitions[partition]};
+            LOCK(source.mutex);
+            for (auto it{inclusive ? source.index.lower_bound(from) : source.index.upper_bound(from)}; it != source.index.end() && window.entries.size() < window.size; ++it) {
+                window.entries.emplace_back(*it);
+            }
+        }
+        window.size = std::min(window.size * 2, MAX_WINDOW_SIZE);
+        if (window.entries.empty()) return;
+        m_heap.push_back(partition);
+        std::ranges::push_heap(m_heap, [this](size_t a, size_t b) { return Greater(a, b); });
+    }
+
+    void Step()
+    {
+        const auto greater{[this](size_t a, size_t b) { return Greater(a, b); }};
+        const size_t partition{m_heap.front()};
+        std::ranges::pop_heap(m_heap, greater);
+        m_heap.pop_back();
+        Window& window{m_windows[partition]};
+        if (++window.pos < window.entries.size()) {
+            m_heap.push_back(partition);
+            std::ranges::push_heap(m_heap, greater);
+        } else {
+            const std::string last{std::move(window.entries.back().first)};
+            Fill(partition, last, /*inclusive=*/false);
+        }
+    }
+
+    void ReadValue()
+    {
+        while (!m_heap.empty()) {
+            auto& [key, location]{Current()};
+            if (const auto segment{m_db.FindPublishedSegment(location.segment)}) {
+                m_value.resize(location.size);
+                segment->Read(location.offset, m_value);
+                return;
+            }
+            // A compaction moved the value and removed the segment since the window was filled
+            bool erased;
+            {
+                const Partition& partition{*m_db.m_partitions[m_heap.front()]};
+                LOCK(partition.mutex);
+                const auto it{partition.index.find(key)};
+                erased = it == partition.index.end();
+                if (!erased) location = it->second;
+            }
+            if (erased) Step();
+        }
+    }
+
+    const LogDB& m_db;
+    std::array<Window, PARTITIONS> m_windows;
+    std::vector<size_t> m_heap;
+    std::vector<std::byte> m_value;
+};
+
+size_t LogDB::KeyHasher::operator()(const std::string& key) const
+{
+    return CSipHasher(k0, k1).Write(UCharSpanCast(std::span{key})).Finalize();
+}
+
+LogDB::LogDB(const fs::path& path, bool memory_only, size_t max_file_size)
+    : m_path{path},
+      m_memory_only{memory_only},
+      m_max_file_size{std::min<uint64_t>(max_file_size, std::numeric_limits<uint32_t>::max())},
+      m_hasher{[] {
+          FastRandomContext rng;
+          return KeyHasher{rng.rand64(), rng.rand64()};
+      }()}
+{
+    for (auto& partition : m_partitions) partition = std::make_unique<Partition>();
+    LOCK(m_write_mutex);
+    if (!memory_only) {
+        TryCreateDirectories(path);
+        LogInfo("Opening LogDB in %s", fs::PathToString(path));
+        if (!Exists(path)) {
+            FILE* marker{fsbridge::fopen(path / fs::u8path(MARKER_FILENAME), "wb")};
+            if (!marker || std::fclose(marker) != 0) throw dbwrapper_error(strprintf("Failed to create LogDB in %s", fs::PathToString(path)));
+        }
+        for (const auto& file : fs::directory_iterator(path)) {
+            if (const auto id{ParseSegmentFilename(fs::PathToString(file.path().filename()))}) {
+                m_segments.emplace(*id, std::make_shared<Segment>(*id, file.path()));
+            }
+        }
+        for (const auto& [id, segment] : m_segments) {
+            Replay(*segment, id == m_segments.rbegin()->first);
+        }
+    }
+    if (m_segments.empty()) AddSegment();
+    PublishSegments();
+    LogInfo("Opened LogDB successfully, with %u segments and %.1f MiB of live entries", m_segments.size(), m_live_bytes / double(1 << 20));
+    m_compaction_thread = std::thread{&util::TraceThread, "logdbcompact", [this] { CompactionThread(); }};
+}
+
+LogDB::~LogDB()
+{
+    WITH_LOCK(m_compaction_signal_mutex, m_stop = true);
+    m_compaction_cv.notify_one();
+    m_compaction_thread.join();
+}
+
+bool LogDB::Exists(const fs::path& path)
+{
+    return fs::exists(path / fs::u8path(MARKER_FILENAME));
+}
+
+bool LogDB::Destroy(const fs::path& path)
+{
+    if (!Exists(path)) return true;
+    std::error_code error;
+    for (const auto& file : fs::directory_iterator(path, error)) {
+        if (ParseSegmentFilename(fs::PathToString(file.path().filename()))) fs::remove(file.path(), error);
+        if (error) return false;
+    }
+    // The marker goes last, so that a database which could not be entirely removed is still recognized
+    fs::remove(path / fs::u8path(MARKER_FILENAME), error);
+    if (error) return false;
+    // Like LevelDB, remove the directory when it is left empty.
+    fs::remove(path, error);
+    return true;
+}
+
+LogDB::Partition& LogDB::GetPartition(const std::string& key) const
+{
+    return *m_partitions[(m_hasher(key) >> 32) % PARTITIONS];
+}
+
+std::shared_ptr<LogDB::Segment> LogDB::FindPublishedSegment(uint32_t id) const
+{
+    LOCK(m_published_mutex);
+    const auto it{m_published_segments.find(id)};
+    return it == m_published_segments.end() ? nullptr : it->second;
+}
+
+void LogDB::PublishSegments()
+{
+    LOCK(m_published_mutex);
+    m_published_segments = m_segments;
+}
+
+LogDB::Segment& LogDB::AddSegment()
+{
+    const uint32_t id{m_segments.empty() ? 0 : m_segments.rbegin()->first + 1};
+    auto segment{std::make_shared<Segment>(id, m_memory_only ? fs::path{} : m_path / fs::u8path(SegmentFilename(id)))};
+    Segment& added{*segment};
+    m_segments.emplace(id, std::move(segment));
+    // Published before the index points to it
+    PublishSegments();
+    return added;
+}
+
+void LogDB::Release(size_t key_size, const Location& location)
+{
+    const uint64_t size{EntrySize(Op::WRITE, key_size, location.size)};
+    m_segments.at(location.segment)->m_live_bytes -= size;
+    m_live_bytes -= size;
+}
+
+void LogDB::ApplyFrame(Segment& segment, uint64_t offset, std::span<const std::byte> payload)
+{
+    for (size_t pos{0}; pos < payload.size();) {
+        const Entry entry{ParseEntry(payload, pos)};
+        const std::string key{KeyString(entry.key)};
+        Partition& partition{GetPartition(key)};
+        LOCK(partition.mutex);
+        if (entry.op == Op::WRITE) {
+            const Location location{
+                .segment = segment.m_id,
+                .offset = static_cast<uint32_t>(offset + FRAME_HEADER_SIZE + entry.value_offset),
+                .size = static_cast<uint32_t>(entry.value.size()),
+            };
+            const auto [it, inserted]{partition.index.try_emplace(key, location)};
+            if (inserted) {
+                m_key_bytes += key.size();
+            } else {
+                Release(key.size(), it->second);
+                it->second = location;
+            }
+            const uint64_t size{EntrySize(Op::WRITE, key.size(), location.size)};
+            segment.m_live_bytes += size;
+            m_live_bytes += size;
+        } else {
+            segment.m_erase_bytes += EntrySize(Op::ERASE, key.size());
+            if (const auto it{partition.index.find(key)}; it != partition.index.end()) {
+                Release(key.size(), it->second);
+                m_key_bytes -= key.size();
+                partition.index.erase(it);
+            }
+        }
+    }
+}
+
+void LogDB::AppendFrame(std::span<std::byte> frame, bool sync)
+{
+    if (frame.size() > std::numeric_limits<uint32_t>::max()) {
+        throw dbwrapper_error("LogDB batch too large");
+    }
+    const auto payload{frame.subspan(FRAME_HEADER_SIZE)};
+    WriteLE32(frame.data(), payload.size());
+    WriteLE32(frame.data() + 4, crc32c::Crc32c(UCharCast(payload.data()), payload.size()));
+
+    Segment* head{m_segments.rbegin()->second.get()};
+    uint64_t offset{head->Size()};
+    if (offset > 0 && offset + frame.size() > m_max_file_size) {
+        // Only the last segment may end with a torn frame
+        head->Sync();
+        head = &AddSegment();
+        offset = 0;
+    }
+    head->Append(frame, sync);
+    m_total_bytes += frame.size();
+    ApplyFrame(*head, offset, payload);
+}
+
+void LogDB::Compact(uint32_t id)
+{
+    const auto start{SteadyClock::now()};
+    std::shared_ptr<Segment> segment;
+    bool oldest;
+    {
+        LOCK(m_write_mutex);
+        segment = m_segments.at(id);
+        // Erasures can only be dropped from the oldest segment, as the others may hide writes in older ones.
+        // Only the compactions remove segments, so it stays the oldest.
+        oldest = id == m_segments.begin()->first;
+    }
+    // The segment is sealed, so it is read without blocking the writes, which may then change the entries found live
+    const std::vector<std::byte> data{segment->ReadAll()};
+    const auto is_live{[&](const Entry& entry, size_t offset) {
+        const std::string key{KeyString(entry.key)};
+        const Partition& partition{GetPartition(key)};
+        LOCK(partition.mutex);
+        const auto it{partition.index.find(key)};
+        if (entry.op == Op::WRITE) return it != partition.index.end() && it->second.segment == id && it->second.offset == offset + entry.value_offset;
+        return !oldest && it == partition.index.end();
+    }};
+    std::vector<std::pair<Entry, size_t>> candidates;
+    for (size_t pos{0}; pos < data.size();) {
+        const auto payload{std::span{data}.subspan(pos + FRAME_HEADER_SIZE, ReadLE32(data.data() + pos))};
+        for (size_t entry_pos{0}; entry_pos < payload.size();) {
+            const Entry entry{ParseEntry(payload, entry_pos)};
+            if (is_live(entry, pos + FRAME_HEADER_SIZE)) candidates.emplace_back(entry, pos + FRAME_HEADER_SIZE);
+        }
+        pos += FRAME_HEADER_SIZE + payload.size();
+    }
+    LOCK(m_write_mutex);
+    Batch live;
+    for (const auto& [entry, offset] : candidates) {
+        if (!is_live(entry, offset)) continue;
+        if (entry.op == Op::WRITE) {
+            live.Put(entry.key, entry.value);
+        } else {
+            live.Delete(entry.key);
+        }
+    }
+    // The live entries must be durable before the segment is removed
+    if (!live.Empty()) AppendFrame(live.m_frame, /*sync=*/true);
+    m_compaction_seconds += Ticks<SecondsDouble>(SteadyClock::now() - start);
+    m_compaction_read_bytes += data.size();
+    m_compaction_written_bytes += live.Empty() ? 0 : live.ApproximateSize();
+    LogDebug(BCLog::LEVELDB, "Compacted LogDB segment %s, rewriting %u of its %u bytes\n",
+             fs::PathToString(segment->m_path), live.Empty() ? 0 : live.ApproximateSize(), data.size());
+    m_segments.erase(id);
+    m_total_bytes -= data.size();
+    PublishSegments();
+    segment->MarkObsolete();
+}
+
+std::optional<uint32_t> LogDB::PickCompaction() const
+{
+    // Reclaim space while more than half of the log is garbage
+    if (m_total_bytes - m_live_bytes <= m_live_bytes) return std::nullopt;
+    const uint32_t oldest{m_segments.begin()->first}, head{m_segments.rbegin()->first};
+    std::optional<uint32_t> best;
+    uint64_t best_garbage{0}, best_size{0};
+    for (const auto& [id, segment] : m_segments) {
+        if (id == head) break;
+        const uint64_t size{segment->Size()};
+        const uint64_t garbage{size - segment->m_live_bytes - (id == oldest ? 0 : segment->m_erase_bytes)};
+        if (garbage > best_garbage) {
+            best = id;
+            best_garbage = garbage;
+            best_size = size;
+        }
+    }
+    // Rewriting a segment costs its live entries, so only do it when it frees at least half of it
+    if (best && best_garbage * 2 >= best_size) return best;
+    return std::nullopt;
+}
+
+void LogDB::ReclaimGarbage()
+{
+    LOCK(m_compaction_mutex);
+    while (!m_stop) {
+        const auto id{WITH_LOCK(m_write_mutex, return PickCompaction())};
+        if (!id) break;
+        Compact(*id);
+    }
+}
+
+void LogDB::CompactionThread()
+{
+    while (true) {
+        {
+            WAIT_LOCK(m_compaction_signal_mutex, lock);
+            m_compaction_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_compaction_signal_mutex) { return m_compaction_requested || m_stop; });
+            if (m_stop) return;
+            m_compaction_requested = false;
+        }
+        try {
+            ReclaimGarbage();
+        } catch (const std::exception& e) {
+            // The log is left as it was, only taking more space
+            LogError("Failed to compact LogDB in %s: %s", fs::PathToString(m_path), e.what());
+        }
+    }
+}
+
+void LogDB::Replay(Segment& segment, bool last)
+{
+    const std::vector<std::byte> data{segment.ReadAll()};
+    size_t pos{0};
+    while (data.size() - pos >= FRAME_HEADER_SIZE) {
+        const uint32_t size{ReadLE32(data.data() + pos)};
+        if (data.size() - pos - FRAME_HEADER_SIZE < size) break;
+        const auto payload{std::span{data}.subspan(pos + FRAME_HEADER_SIZE, size)};
+        if (ReadLE32(data.data() + pos + 4) != crc32c::Crc32c(UCharCast(payload.data()), payload.size())) break;
+        ApplyFrame(segment, pos, payload);
+        pos += FRAME_HEADER_SIZE + size;
+    }
+    if (pos < data.size()) {
+        if (!last) throw dbwrapper_error(strprintf("Corrupted LogDB segment %s", fs::PathToString(segment.m_path)));
+        LogWarning("Discarding %u bytes of an incomplete write at the end of LogDB segment %s", data.size() - pos, fs::PathToString(segment.m_path));
+        segment.Truncate(pos);
+    }
+    m_total_bytes += pos;
+}
+
+std::optional<std::string> LogDB::Read(std::span<const std::byte> key) const
+{
+    ++m_lookups;
+    const std::string key_str{KeyString(key)};
+    const Partition& partition{GetPartition(key_str)};
+    while (true) {
+        Location location;
+        {
+            LOCK(partition.mutex);
+            const auto it{partition.index.find(key_str)};
+            if (it == partition.index.end()) return std::nullopt;
+            location = it->second;
+        }
+        // Otherwise, a compaction moved the value and removed the segment since the lookup.
+        if (const auto segment{FindPublishedSegment(location.segment)}) {
+            ++m_lookup_file_reads;
+            std::string value(location.size, '\0');
+            segment->Read(location.offset, MakeWritableByteSpan(value));
+            return value;
+        }
+    }
+}
+
+bool LogDB::Exists(std::span<const std::byte> key) const
+{
+    ++m_lookups;
+    const std::string key_str{KeyString(key)};
+    const Partition& partition{GetPartition(key_str)};
+    LOCK(partition.mutex);
+    return partition.index.contains(key_str);
+}
+
+std::unique_ptr<DBEngineBatch> LogDB::NewBatch() const
+{
+    return std::make_unique<Batch>();
+}
+
+void LogDB::Write(DBEngineBatch& batch, bool sync)
+{
+    auto& log_batch{static_cast<Batch&>(batch)};
+    LOCK(m_write_mutex);
+    if (log_batch.Empty()) {
+        if (sync) m_segments.rbegin()->second->Sync();
+        return;
+    }
+    AppendFrame(log_batch.m_frame, sync);
+    if (m_total_bytes - m_live_bytes > m_live_bytes) {
+        WITH_LOCK(m_compaction_signal_mutex, m_compaction_requested = true);
+        m_compaction_cv.notify_one();
+    }
+}
+
+std::unique_ptr<DBEngineIterator> LogDB::NewIterator() const
+{
+    return std::make_unique<Iterator>(*this);
+}
+
+size_t LogDB::EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const
+{
+    const std::string begin_key{KeyString(begin)}, end_key{KeyString(end)};
+    size_t size{0};
+    for (const auto& partition : m_partitions) {
+        LOCK(partition->mutex);
+        for (auto it{partition->index.lower_bound(begin_key)}; it != partition->index.end() && it->first < end_key; ++it) {
+            size += EntrySize(Op::WRITE, it->first.size(), it->second.size);
+        }
+    }
+    return size;
+}
+
+size_t LogDB::DynamicMemoryUsage() const
+{
+    LOCK(m_write_mutex);
+    size_t usage{m_key_bytes + (m_memory_only ? m_total_bytes : 0)};
+    for (const auto& partition : m_partitions) {
+        LOCK(partition->mutex);
+        usage += memusage::DynamicUsage(partition->index);
+    }
+    return usage;
+}
+
+void LogDB::CompactAll()
+{
+    LOCK(m_compaction_mutex);
+    std::vector<uint32_t> sealed;
+    {
+        LOCK(m_write_mutex);
+        // Seal the head segment, so that every entry is rewritten
+        if (m_segments.rbegin()->second->Size() > 0) {
+            m_segments.rbegin()->second->Sync();
+            AddSegment();
+        }
+        for (const auto& [id, segment] : m_segments) sealed.push_back(id);
+        sealed.pop_back();
+    }
+    // In order, so each one is the oldest when compacted
+    for (const uint32_t id : sealed) Compact(id);
+}
+
+DBStats LogDB::GetStats() const
+{
+    DBStats stats;
+    stats.lookups = m_lookups;
+    stats.lookup_file_reads = m_lookup_file_reads;
+    stats.memory_usage = DynamicMemoryUsage();
+    LOCK(m_write_mutex);
+    DBStats::Level& level{stats.levels.emplace_back()};
+    level.files = m_segments.size();
+    level.bytes = m_total_bytes;
+    level.compaction_seconds = m_compaction_seconds;
+    level.compaction_read_bytes = m_compaction_read_bytes;
+    level.compaction_written_bytes = m_compaction_written_bytes;
+    return stats;
+}
+
+size_t LogDB::SegmentCount() const
+{
+    LOCK(m_write_mutex);
+    return m_segments.size();
+}
+
+uint64_t LogDB::TotalBytes() const
+{
+    LOCK(m_write_mutex);
+    return m_total_bytes;
+}
+
+uint64_t LogDB::LiveBytes() const
+{
+    LOCK(m_write_mutex);
+    return m_live_bytes;
+}
+
+size_t LogDB::OpenFileCount()
+{
+    return g_open_segment_files.Count();
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_LOGDB_H
+#define BITCOIN_LOGDB_H
+
+#include <dbengine.h>
+#include <sync.h>
+#include <util/fs.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+/**
+ * Log structured storage engine, selected with -dbengine=logdb.
+ *
+ * Every write batch is appended as one checksummed frame to the newest segment of a log, and an index
+ * kept entirely in memory maps each key to the location of its latest value. The index is split into
+ * sorted partitions by a salted hash of the keys, each with its own lock, so concurrent reads rarely contend.
+ * A read is a single positioned read from a segment, and writes are sequential whatever the key order.
+ *
+ * While more than half of the log is garbage, a background thread reclaims the segments with the most
+ * garbage, by appending their live entries to the log and deleting them.
+ *
+ * The segments are replayed to rebuild the index when the database is opened. A frame torn by a crash at
+ * the end of the log is discarded, so a batch is either entirely written or not at all.
+ *
+ * Iterators merge the partitions lazily, so positioning one does not depend on the size of the database.
+ * Unlike those of LevelDB, they are not snapshots: the writes made while iterating may or may not be seen.
+ */
+class LogDB final : public DBEngine
+{
+public:
+    //! Name of the file marking a directory as holding a LogDB database
+    static constexpr std::string_view MARKER_FILENAME{"LOGDB"};
+    //! Maximum number of segment files open at once over all the databases, the least recently used being closed
+    static constexpr size_t MAX_OPEN_FILES{64};
+
+    LogDB(const fs::path& path, bool memory_only, size_t max_file_size);
+    ~LogDB() override;
+
+    //! Whether the directory holds a LogDB database
+    static bool Exists(const fs::path& path);
+    //! Remove the files of the database in the directory.
+    static bool Destroy(const fs::path& path);
+
+    std::optional<std::string> Read(std::span<const std::byte> key) const override;
+    bool Exists(std::span<const std::byte> key) const override;
+    std::unique_ptr<DBEngineBatch> NewBatch() const override;
+    void Write(DBEngineBatch& batch, bool sync) override EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex, !m_compaction_signal_mutex);
+    std::unique_ptr<DBEngineIterator> NewIterator() const override;
+    size_t EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const override;
+    size_t DynamicMemoryUsage() const override EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    void CompactAll() override EXCLUSIVE_LOCKS_REQUIRED(!m_compaction_mutex, !m_write_mutex);
+    //! The segments make up a single level.
+    DBStats GetStats() const override EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+
+    size_t SegmentCount() const EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    //! Bytes of the log
+    uint64_t TotalBytes() const EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    //! Bytes of the log entries that are neither overwritten nor erased
+    uint64_t LiveBytes() const EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    //! Compact segments until at most half of the log is garbage, as the background thread does after the
+    //! writes. Public for the tests, which cannot tell when the latter is done.
+    void ReclaimGarbage() EXCLUSIVE_LOCKS_REQUIRED(!m_compaction_mutex, !m_write_mutex);
+    //! Number of segment files open over all the databases
+    static size_t OpenFileCount();
+
+    class Segment;
+
+    //! Where the value of a key is stored
+    struct Location {
+        uint32_t segment;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+private:
+    class Batch;
+    class Iterator;
+
+    struct KeyHasher {
+        uint64_t k0, k1;
+        size_t operator()(const std::string& key) const;
+    };
+
+    using Index = std::map<std::string, Location, std::less<>>;
+    using Segments = std::map<uint32_t, std::shared_ptr<Segment>>;
+
+    struct Partition {
+        mutable Mutex mutex;
+        Index index GUARDED_BY(mutex);
+    };
+
+    static constexpr size_t PARTITIONS{16};
+
+    const fs::path m_path;
+    const bool m_memory_only;
+    const uint64_t m_max_file_size;
+    const KeyHasher m_hasher;
+    std::array<std::unique_ptr<Partition>, PARTITIONS> m_partitions;
+
+    //! Serializes the compactions, whose segment reads do not block the writes. Acquired before m_write_mutex.
+    Mutex m_compaction_mutex;
+    //! Serializes the changes to the index and the log, made by the writes and by the compactions once they read a segment
+    mutable Mutex m_write_mutex;
+    Segments m_segments GUARDED_BY(m_write_mutex);
+    uint64_t m_total_bytes GUARDED_BY(m_write_mutex){0};
+    uint64_t m_live_bytes GUARDED_BY(m_write_mutex){0};
+    //! Sum of the key sizes in the index, for the memory usage
+    uint64_t m_key_bytes GUARDED_BY(m_write_mutex){0};
+    double m_compaction_seconds GUARDED_BY(m_write_mutex){0};
+    uint64_t m_compaction_read_bytes GUARDED_BY(m_write_mutex){0};
+    uint64_t m_compaction_written_bytes GUARDED_BY(m_write_mutex){0};
+
+    mutable std::atomic<uint64_t> m_lookups{0};
+    mutable std::atomic<uint64_t> m_lookup_file_reads{0};
+
+    //! Copy of m_segments for the reads, which do not wait for the writes
+    mutable Mutex m_published_mutex;
+    Segments m_published_segments GUARDED_BY(m_published_mutex);
+
+    Mutex m_compaction_signal_mutex;
+    std::condition_variable m_compaction_cv;
+    bool m_compaction_requested GUARDED_BY(m_compaction_signal_mutex){false};
+    std::atomic<bool> m_stop{false};
+    std::thread m_compaction_thread;
+
+    Partition& GetPartition(const std::string& key) const;
+    std::shared_ptr<Segment> FindPublishedSegment(uint32_t id) const EXCLUSIVE_LOCKS_REQUIRED(!m_published_mutex);
+    void PublishSegments() EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex, !m_published_mutex);
+    Segment& AddSegment() EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex, !m_published_mutex);
+    //! Account for a value which is overwritten or erased.
+    void Release(size_t key_size, const Location& location) EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex);
+    //! Point the index to the entries of a frame written at the given offset of a segment.
+    void ApplyFrame(Segment& segment, uint64_t offset, std::span<const std::byte> payload) EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex);
+    //! Append a frame built by a Batch to the log, and point the index to its entries.
+    void AppendFrame(std::span<std::byte> frame, bool sync) EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex, !m_published_mutex);
+    //! Rewrite the live entries of a sealed segment at the head of the log, and delete it.
+    void Compact(uint32_t id) EXCLUSIVE_LOCKS_REQUIRED(m_compaction_mutex, !m_write_mutex, !m_published_mutex);
+    //! The segment worth compacting, if more than half of the log is garbage
+    std::optional<uint32_t> PickCompaction() const EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex);
+    void CompactionThread() EXCLUSIVE_LOCKS_REQUIRED(!m_compaction_signal_mutex, !m_compaction_mutex, !m_write_mutex);
+    void Replay(Segment& segment, bool last) EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex);
+};
+
+#endif // BITCOIN_LOGDB_H
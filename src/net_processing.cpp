@@ -42,6 +42,7 @@
 #include <policy/fees/block_policy_estimator.h>
 #include <policy/packages.h>
 #include <policy/policy.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <private_broadcast.h>
@@ -194,6 +195,15 @@ static constexpr double MAX_ADDR_RATE_PER_SECOND{0.1};
  *  based increments won't go above this, but the MAX_ADDR_TO_SEND increment following GETADDR
  *  is exempt from this limit). */
 static constexpr size_t MAX_ADDR_PROCESSING_TOKEN_BUCKET{MAX_ADDR_TO_SEND};
+/** The PoW verification time, in seconds per second, an inbound peer may use on average before its messages are
+ *  deferred, so bogus headers from a few peers cannot delay the processing of the others. */
+static constexpr double MAX_POW_CHECK_RATE{0.25};
+/** Outbound and NetPermissionFlags::NoBan peers, which are less likely to be attackers, may use this many times more. */
+static constexpr double PREFERRED_POW_CHECK_RATE_FACTOR{16};
+/** The PoW verification time budget is capped to this much time at its rate, allowing bursts after idle periods. */
+static constexpr auto MAX_POW_CHECK_BURST{30s};
+/** Maximum number of serialized batches of headers kept to answer getheaders. */
+static constexpr size_t MAX_CACHED_HEADERS_BATCHES{64};
 /** For private broadcast, send a transaction to this many peers. */
 static constexpr size_t NUM_PRIVATE_BROADCAST_PER_TX{3};
 /** Private broadcast connections must complete within this time. Disconnect the peer if it takes longer. */
@@ -406,6 +416,19 @@ struct Peer {
      * timestamp the peer sent in the version message. */
     std::atomic<std::chrono::seconds> m_time_offset{0s};
 
+    /** Time spent checking the PoW of the headers and blocks received from
+     * this peer, in microseconds. Batches verified by several threads count
+     * for their wall-clock time. */
+    std::atomic<int64_t> m_pow_check_time{0};
+    /** PoW verification time this peer may still use before its messages are
+     * deferred, in seconds. It can become negative, as a message is processed
+     * entirely once started. */
+    double m_pow_check_budget GUARDED_BY(NetEventsInterface::g_msgproc_mutex){MAX_POW_CHECK_RATE * count_seconds(MAX_POW_CHECK_BURST)};
+    /** When m_pow_check_budget was last updated */
+    NodeClock::time_point m_pow_check_budget_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){NodeClock::now()};
+    /** Part of m_pow_check_time already charged to m_pow_check_budget */
+    int64_t m_pow_check_time_charged GUARDED_BY(NetEventsInterface::g_msgproc_mutex){0};
+
     explicit Peer(NodeId id, ServiceFlags our_services, bool is_inbound)
         : m_id{id}
         , m_our_services{our_services}
@@ -540,6 +563,7 @@ public:
         m_best_block_time = time;
     };
     void UnitTestMisbehaving(NodeId peer_id) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex) { Misbehaving(*Assert(GetPeerRef(peer_id)), ""); };
+    void UnitTestChargePoWCheckTime(NodeId peer_id, std::chrono::microseconds time) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex) { Assert(GetPeerRef(peer_id))->m_pow_check_time += count_microseconds(time); };
     void UpdateLastBlockAnnounceTime(NodeId node, int64_t time_in_seconds) override;
     ServiceFlags GetDesirableServiceFlags(ServiceFlags services) const override;
 
@@ -632,6 +656,12 @@ private:
     bool ProcessOrphanTx(Peer& peer)
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, g_msgproc_mutex, !m_tx_download_mutex);
 
+    /** Refill the PoW verification budget of a peer and charge it with the
+     * time spent since the last call.
+     * @return True if the peer has budget left, so its next message can be processed.
+     */
+    bool UpdatePoWCheckBudget(const CNode& node, Peer& peer) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+
     /** Process a single headers message from a peer.
      *
      * @param[in]   pfrom     CNode of the peer
@@ -650,6 +680,11 @@ private:
     void HandleUnconnectingHeaders(CNode& pfrom, Peer& peer, const std::vector<CBlockHeader>& headers) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
     /** Return true if the headers connect to each other, false otherwise */
     bool CheckHeadersAreContinuous(const std::vector<CBlockHeader>& headers) const;
+    /** Return false if the cheap PoW pre-screen proves one of the new headers
+     * invalid, so bogus announcements are rejected before the expensive
+     * primality tests. Headers with an implausible nBits are left to the
+     * contextual checks, as their pre-screen is not cheap. */
+    bool PreScreenHeadersPoW(const std::vector<CBlockHeader>& headers) const EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
     /** Request further headers from this peer with a given locator.
      * We don't issue a getheaders message if we have a recent one outstanding.
      * This returns true if a getheaders is actually sent, and false otherwise.
@@ -813,6 +848,22 @@ private:
     /** Height of the highest block announced using BIP 152 high-bandwidth mode. */
     int m_highest_fast_announce GUARDED_BY(::cs_main){0};
 
+    /** A headers message of MAX_HEADERS_RESULTS headers of the active chain, serialized once for all the syncing peers. */
+    struct HeadersBatch {
+        //! Hash of the last header, which changes if the batch was reorganized
+        uint256 last_hash;
+        CSerializedNetMsg msg;
+        uint64_t last_use;
+    };
+    /** Cached batches, by number. They start at heights 1 mod MAX_HEADERS_RESULTS, as the Known Header Batches of the
+     *  Checkpoints, since a first Sync requests them in this order. The least recently used ones are evicted. */
+    std::map<int, HeadersBatch> m_headers_batches GUARDED_BY(::cs_main);
+    uint64_t m_headers_batches_uses GUARDED_BY(::cs_main){0};
+
+    /** Get the headers message answering a getheaders whose first header is first and which stops at hash_stop,
+     *  if it is a complete batch of the active chain. */
+    const CSerializedNetMsg* GetHeadersBatch(const CBlockIndex& first, const uint256& hash_stop) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /** Have we requested this block from a peer */
     bool IsBlockRequested(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -1757,6 +1808,7 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) c
     stats.m_addr_rate_limited = peer->m_addr_rate_limited.load();
     stats.m_addr_relay_enabled = peer->m_addr_relay_enabled.load();
     stats.time_offset = peer->m_time_offset;
+    stats.m_pow_check_time = std::chrono::microseconds{peer->m_pow_check_time.load()};
 
     return true;
 }
@@ -2008,6 +2060,41 @@ void PeerManagerImpl::BlockConnected(
     }
 }
 
+const CSerializedNetMsg* PeerManagerImpl::GetHeadersBatch(const CBlockIndex& first, const uint256& hash_stop)
+{
+    AssertLockHeld(cs_main);
+    const int batch_size{static_cast<int>(MAX_HEADERS_RESULTS)};
+    const CChain& chain{m_chainman.ActiveChain()};
+    if (m_opts.max_headers_result != MAX_HEADERS_RESULTS || first.nHeight % batch_size != 1 || chain[first.nHeight] != &first)
+        return nullptr;
+    const CBlockIndex* last{chain[first.nHeight + batch_size - 1]};
+    if (!last)
+        return nullptr;
+    // A hash_stop before the end of the batch asks for fewer headers
+    if (!hash_stop.IsNull() && hash_stop != last->GetBlockHash()) {
+        const CBlockIndex* stop{m_chainman.m_blockman.LookupBlockIndex(hash_stop)};
+        if (stop && stop->nHeight >= first.nHeight && stop->nHeight < last->nHeight && chain.Contains(*stop))
+            return nullptr;
+    }
+    auto it{m_headers_batches.find(first.nHeight/batch_size)};
+    if (it == m_headers_batches.end() || it->second.last_hash != last->GetBlockHash()) {
+        if (it == m_headers_batches.end() && m_headers_batches.size() >= MAX_CACHED_HEADERS_BATCHES) {
+            m_headers_batches.erase(std::min_element(m_headers_batches.begin(), m_headers_batches.end(), [](const auto& a, const auto& b) {
+                return a.second.last_use < b.second.last_use;
+            }));
+        }
+        // we must use CBlocks, as CBlockHeaders won't include the 0x00 nTx count at the end
+        std::vector<CBlock> headers;
+        headers.reserve(batch_size);
+        for (const CBlockIndex* pindex{&first}; pindex != last; pindex = chain.Next(*pindex))
+            headers.emplace_back(pindex->GetBlockHeader());
+        headers.emplace_back(last->GetBlockHeader());
+        it = m_headers_batches.insert_or_assign(first.nHeight/batch_size, HeadersBatch{last->GetBlockHash(), NetMsg::Make(NetMsgType::HEADERS, TX_WITH_WITNESS(headers)), 0}).first;
+    }
+    it->second.last_use = ++m_headers_batches_uses;
+    return &it->second.msg;
+}
+
 void PeerManagerImpl::BlockDisconnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex* pindex)
 {
     LOCK(m_tx_download_mutex);
@@ -2567,6 +2654,23 @@ bool PeerManagerImpl::CheckHeadersAreContinuous(const std::vector<CBlockHeader>&
     return true;
 }
 
+bool PeerManagerImpl::PreScreenHeadersPoW(const std::vector<CBlockHeader>& headers) const
+{
+    std::vector<const CBlockHeader*> new_headers;
+    {
+        LOCK(cs_main);
+        const uint64_t max_nbits{static_cast<uint64_t>(m_chainman.m_best_header->nBits) + MAX_HEADERS_PREVALIDATION_NBITS_INCREASE};
+        for (const CBlockHeader& header : headers) {
+            if (header.nBits <= max_nbits && !m_chainman.m_blockman.LookupBlockIndex(header.GetHash())) {
+                new_headers.push_back(&header);
+            }
+        }
+    }
+    return std::all_of(new_headers.begin(), new_headers.end(), [&](const CBlockHeader* header) {
+        return PreScreenProofOfWork(header->GetHashForPoW(), header->nBits, ArithToUint256(header->nNonce), m_chainparams.GetConsensus());
+    });
+}
+
 bool PeerManagerImpl::MaybeSendGetHeaders(CNode& pfrom, const CBlockLocator& locator, Peer& peer)
 {
     const auto current_time = NodeClock::now();
@@ -2754,6 +2858,15 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
         return;
     }
 
+    // Announcements are pre-screened, larger batches are either known from the
+    // checkpoints or verified in parallel by ProcessNewBlockHeaders.
+    if (nCount <= MAX_BLOCKS_TO_ANNOUNCE && !PreScreenHeadersPoW(headers)) {
+        BlockValidationState state;
+        state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "short-constellation", "proof of work failed pre-screen");
+        MaybePunishNodeForBlock(pfrom.GetId(), state, via_compact_block, "invalid header received");
+        return;
+    }
+
     // If we don't have the last header, then this peer will have given us
     // something new (if these headers are valid).
     bool received_new_header{WITH_LOCK(::cs_main, return m_chainman.m_blockman.LookupBlockIndex(headers.back().GetHash()) == nullptr)};
@@ -4023,6 +4136,11 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
         std::vector<CBlock> vHeaders;
         int nLimit = m_opts.max_headers_result;
         LogDebug(BCLog::NET, "getheaders %d to %s from peer=%d\n", (pindex ? pindex->nHeight : -1), hashStop.IsNull() ? "end" : hashStop.ToString(), pfrom.GetId());
+        if (const CSerializedNetMsg* batch{pindex ? GetHeadersBatch(*pindex, hashStop) : nullptr}) {
+            nodestate->pindexBestHeaderSent = m_chainman.ActiveChain()[pindex->nHeight + static_cast<int>(MAX_HEADERS_RESULTS) - 1];
+            m_connman.PushMessage(&pfrom, batch->Copy());
+            return;
+        }
         for (; pindex; pindex = m_chainman.ActiveChain().Next(*pindex))
         {
             vHeaders.emplace_back(pindex->GetBlockHeader());
@@ -4159,6 +4277,11 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
 
         const CBlockIndex *pindex = nullptr;
         BlockValidationState state;
+        if (received_new_header && !PreScreenHeadersPoW({cmpctblock.header})) {
+            state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "short-constellation", "proof of work failed pre-screen");
+            MaybePunishNodeForBlock(pfrom.GetId(), state, /*via_compact_block=*/true, "invalid header via cmpctblock");
+            return;
+        }
         if (!m_chainman.ProcessNewBlockHeaders({{cmpctblock.header}}, state, &pindex)) {
             if (state.IsInvalid()) {
                 MaybePunishNodeForBlock(pfrom.GetId(), state, /*via_compact_block=*/true, "invalid header via cmpctblock");
@@ -4695,6 +4818,21 @@ bool PeerManagerImpl::MaybeDiscourageAndDisconnect(CNode& pnode, Peer& peer)
     return true;
 }
 
+bool PeerManagerImpl::UpdatePoWCheckBudget(const CNode& node, Peer& peer)
+{
+    const bool preferred{!node.IsInboundConn() || node.HasPermission(NetPermissionFlags::NoBan)};
+    const double rate{MAX_POW_CHECK_RATE * (preferred ? PREFERRED_POW_CHECK_RATE_FACTOR : 1.0)};
+    const auto current_time{NodeClock::now()};
+    const auto time_diff{current_time - peer.m_pow_check_budget_timestamp};
+    peer.m_pow_check_budget = std::min(peer.m_pow_check_budget + std::max(Ticks<SecondsDouble>(time_diff), 0.0) * rate,
+                                       rate * count_seconds(MAX_POW_CHECK_BURST));
+    peer.m_pow_check_budget_timestamp = current_time;
+    const int64_t pow_check_time{peer.m_pow_check_time.load()};
+    peer.m_pow_check_budget -= (pow_check_time - peer.m_pow_check_time_charged) / 1e6;
+    peer.m_pow_check_time_charged = pow_check_time;
+    return peer.m_pow_check_budget > 0;
+}
+
 bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(m_tx_download_mutex);
@@ -4732,6 +4870,11 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     // Don't bother if send buffer is too full to respond anyway
     if (node.fPauseSend) return false;
 
+    // Peers that used up their PoW verification budget wait for it to refill,
+    // while the messages of the other peers are processed. Their receive
+    // buffer then fills up, which also stops reading from them.
+    if (!UpdatePoWCheckBudget(node, peer)) return false;
+
     auto poll_result{node.PollMessage()};
     if (!poll_result) {
         // No message to process
@@ -4755,7 +4898,10 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     }
 
     try {
-        ProcessMessage(peer, node, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        {
+            const PoWCostScope pow_cost_scope{&peer.m_pow_check_time};
+            ProcessMessage(peer, node, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        }
         if (interruptMsgProc) return false;
         {
             LOCK(peer.m_getdata_requests_mutex);
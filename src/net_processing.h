@@ -66,6 +66,7 @@ struct CNodeStateStats {
     bool m_addr_relay_enabled{false};
     ServiceFlags their_services;
     std::chrono::seconds time_offset{0};
+    std::chrono::microseconds m_pow_check_time{0};
 };
 
 struct PeerManagerInfo {
@@ -158,6 +159,9 @@ public:
     /* Public for unit testing. */
     virtual void UnitTestMisbehaving(NodeId peer_id) = 0;
 
+    /* Public for unit testing. */
+    virtual void UnitTestChargePoWCheckTime(NodeId peer_id, std::chrono::microseconds time) = 0;
+
     /**
      * Evict extra outbound peers. If we think our tip may be stale, connect to an extra outbound.
      * Public for unit testing.
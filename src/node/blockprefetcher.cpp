@@ -0,0 +1,78 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockprefetcher.h>
+
+#include <chain.h>
+#include <consensus/consensus.h>
+#include <flatfile.h>
+#include <kernel/cs_main.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <algorithm>
+
+namespace node {
+BlockPrefetcher::BlockPrefetcher(const BlockManager& blockman, int workers, size_t max_blocks, size_t max_bytes)
+    : m_blockman{blockman}, m_max_blocks{max_blocks}, m_max_bytes{max_bytes}
+{
+    if (workers > 0 && m_max_blocks > 0)
+        m_pool.Start(workers);
+}
+
+BlockPrefetcher::~BlockPrefetcher()
+{
+    // The pending reads must complete while the BlockManager is alive
+    m_queue.clear();
+    m_pool.Stop();
+}
+
+static std::shared_ptr<const CBlock> ReadBlock(const BlockManager& blockman, const FlatFilePos& pos, const uint256& hash)
+{
+    auto block{std::make_shared<CBlock>()};
+    if (!blockman.ReadBlock(*block, pos, hash))
+        return nullptr;
+    return block;
+}
+
+std::shared_ptr<const CBlock> BlockPrefetcher::Read(const CBlockIndex& index, const NextBlockFn& next)
+{
+    std::shared_ptr<const CBlock> block;
+    if (!m_queue.empty() && m_queue.front().index == &index) {
+        block = m_queue.front().block.get();
+        m_queue.pop_front();
+    } else {
+        m_queue.clear();
+        block = ReadBlock(m_blockman, WITH_LOCK(::cs_main, return index.GetBlockPos()), index.GetBlockHash());
+    }
+    if (block) {
+        m_read_bytes += GetSerializeSize(TX_WITH_WITNESS(*block));
+        m_read_blocks++;
+    }
+
+    if (m_pool.WorkersCount() == 0)
+        return block;
+    const size_t average_size{m_read_blocks > 0 ? std::max<size_t>(m_read_bytes/m_read_blocks, 1) : MAX_BLOCK_SERIALIZED_SIZE};
+    const size_t max_blocks{std::min(m_max_blocks, m_max_bytes/average_size)};
+    const CBlockIndex* last{m_queue.empty() ? &index : m_queue.back().index};
+    while (m_queue.size() < max_blocks) {
+        const CBlockIndex* pindex{next(*last)};
+        if (!pindex)
+            break;
+        // The position is taken here, so the background reads do not need cs_main, which the consumer may hold
+        const FlatFilePos pos{WITH_LOCK(::cs_main, return pindex->GetBlockPos())};
+        if (pos.IsNull())
+            break;
+        auto future{m_pool.Submit([this, pos, hash = pindex->GetBlockHash()] { return ReadBlock(m_blockman, pos, hash); })};
+        if (!future)
+            break;
+        m_queue.push_back({pindex, std::move(*future)});
+        last = pindex;
+    }
+    return block;
+}
+} // namespace node
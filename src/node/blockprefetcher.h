@@ -0,0 +1,71 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKPREFETCHER_H
+#define BITCOIN_NODE_BLOCKPREFETCHER_H
+
+#include <util/byte_units.h>
+#include <util/threadpool.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+class CBlock;
+class CBlockIndex;
+
+namespace node {
+class BlockManager;
+
+static constexpr int DEFAULT_BLOCK_PREFETCH_WORKERS{2};
+static constexpr size_t DEFAULT_BLOCK_PREFETCH_MAX_BLOCKS{32};
+static constexpr size_t DEFAULT_BLOCK_PREFETCH_MAX_BYTES{64_MiB};
+
+/**
+ * Reads the blocks that a consumer walking them in order is about to process on background
+ * threads, so their disk reads and deserialization overlap with the processing of the current one.
+ *
+ * The consumer reads each block with Read, giving how to find the block following a given one.
+ * The blocks are prefetched along this walk, up to a number of blocks and an estimated memory
+ * use. If the consumer reads another block than the expected one, for example after a
+ * reorganization, the prefetched blocks are dropped and the walk restarts from it.
+ *
+ * A block without data is not prefetched, its read and its error are left to the consumer.
+ * Callers may hold cs_main, which the background reads do not take.
+ */
+class BlockPrefetcher
+{
+public:
+    //! Returns the block to read after the given one, or nullptr if there is none or it is not known yet
+    using NextBlockFn = std::function<const CBlockIndex*(const CBlockIndex&)>;
+
+    BlockPrefetcher(const BlockManager& blockman,
+                    int workers = DEFAULT_BLOCK_PREFETCH_WORKERS,
+                    size_t max_blocks = DEFAULT_BLOCK_PREFETCH_MAX_BLOCKS,
+                    size_t max_bytes = DEFAULT_BLOCK_PREFETCH_MAX_BYTES);
+    ~BlockPrefetcher();
+
+    /** Read the block of index, nullptr on failure, and prefetch the following ones. */
+    std::shared_ptr<const CBlock> Read(const CBlockIndex& index, const NextBlockFn& next);
+
+private:
+    struct PrefetchedBlock {
+        const CBlockIndex* index;
+        std::future<std::shared_ptr<const CBlock>> block;
+    };
+
+    const BlockManager& m_blockman;
+    const size_t m_max_blocks;
+    const size_t m_max_bytes;
+    ThreadPool m_pool{"blkprefetch"};
+    std::deque<PrefetchedBlock> m_queue;
+    //! Size of the blocks read so far, to estimate the memory used by the prefetched ones
+    size_t m_read_bytes{0};
+    size_t m_read_blocks{0};
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKPREFETCHER_H
@@ -37,23 +37,62 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <compare>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdio>
 #include <exception>
 #include <map>
+#include <numeric>
 #include <optional>
 #include <ostream>
 #include <span>
 #include <stdexcept>
 #include <system_error>
+#include <thread>
 #include <unordered_map>
 
+//! Maximum number of worker threads loading the block index at startup
+static constexpr int MAX_BLOCK_INDEX_LOAD_WORKERS{7};
+//! Number of block index entries read by a loading thread before inserting them all at once
+static constexpr size_t BLOCK_INDEX_LOAD_BATCH_SIZE{1024};
+
+namespace {
+/** Calls a function when leaving the scope, normally or by an exception */
+template <typename F>
+class ScopeExit
+{
+    F m_fn;
+
+public:
+    explicit ScopeExit(F fn) : m_fn{std::move(fn)} {}
+    ~ScopeExit() { m_fn(); }
+    ScopeExit(const ScopeExit&) = delete;
+    ScopeExit& operator=(const ScopeExit&) = delete;
+};
+} // namespace
+
+/** Run the tasks on the workers of the pool and the calling thread, or only on the latter if the pool has no workers, and return whether they all succeeded */
+static bool RunBlockIndexLoadTasks(ThreadPool* pool, std::vector<std::function<bool()>>&& tasks)
+{
+    const auto run_inline{[&tasks] { return std::ranges::all_of(tasks, [](const std::function<bool()>& task) { return task(); }); }};
+    if (!pool) return run_inline();
+    auto futures{pool->Submit(std::move(tasks))};
+    if (!futures) return run_inline(); // The tasks were not consumed
+    // Take part in the work instead of idly waiting for the workers
+    while (pool->ProcessTask()) {}
+    bool success{true};
+    for (auto& future : *futures) success &= future.get();
+    return success;
+}
+
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
 static constexpr uint8_t DB_BLOCK_INDEX{'b'};
@@ -117,21 +156,67 @@ bool BlockTreeDB::ReadFlag(const std::string& name, bool& fValue)
     return true;
 }
 
-bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt, ThreadPool* pool)
 {
     AssertLockHeld(::cs_main);
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
-
-    // Load m_block_index
-    while (pcursor->Valid()) {
-        if (interrupt) return false;
-        std::pair<uint8_t, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
+    // The keys are ordered by the first byte of the hash, whose values split the entries into ranges of roughly equal size that are read independently.
+    // Deserializing the entries and hashing their headers dominates, so it is done in parallel, and the entries are handed by batches to this thread,
+    // which holds cs_main and is the only one inserting them into the block index.
+    using Entries = std::vector<std::pair<uint256, CDiskBlockIndex>>;
+    Mutex batches_mutex;
+    std::condition_variable batches_cv;
+    std::vector<Entries> batches;
+    const size_t range_count{pool ? std::min<size_t>((pool->WorkersCount() + 1)*4, 256) : 1};
+    size_t running_tasks{range_count};
+    const auto hand_over{[&](Entries& entries) {
+        if (entries.empty()) return;
+        {
+            LOCK(batches_mutex);
+            batches.push_back(std::move(entries));
+        }
+        batches_cv.notify_one();
+        entries = Entries{};
+        entries.reserve(BLOCK_INDEX_LOAD_BATCH_SIZE);
+    }};
+    const auto read_range{[&](size_t first_byte, size_t end_byte) {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        uint256 start;
+        start.data()[0] = static_cast<uint8_t>(first_byte);
+        pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, start));
+        Entries entries;
+        entries.reserve(BLOCK_INDEX_LOAD_BATCH_SIZE);
+        while (pcursor->Valid()) {
+            if (interrupt) return false;
+            std::pair<uint8_t, uint256> key;
+            if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX || key.second.data()[0] >= end_byte)
+                break;
             CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
+            if (!pcursor->GetValue(diskindex)) {
+                LogError("LoadBlockIndexGuts: failed to read value\n");
+                return false;
+            }
+            // The Block Index only contains Headers whose PoW was verified when they were accepted, and the Block Hash commits to all the PoW data.
+            // So, rather than running the very expensive PoW Check again, just check that the Header is consistent with its Hash.
+            const uint256 hash{diskindex.ConstructBlockHash()};
+            if (hash != key.second) {
+                LogError("LoadBlockIndexGuts: block index entry %s is inconsistent with its header (%s)\n", key.second.ToString(), hash.ToString());
+                return false;
+            }
+            entries.emplace_back(hash, std::move(diskindex));
+            if (entries.size() == BLOCK_INDEX_LOAD_BATCH_SIZE)
+                hand_over(entries);
+            pcursor->Next();
+        }
+        hand_over(entries);
+        return true;
+    }};
+    const auto insert_batches{[&]() EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+        std::vector<Entries> ready;
+        WITH_LOCK(batches_mutex, ready.swap(batches));
+        for (const auto& entries : ready) {
+            for (const auto& [hash, diskindex] : entries) {
                 // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.ConstructBlockHash());
+                CBlockIndex* pindexNew = insertBlockIndex(hash);
                 pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
                 pindexNew->nHeight        = diskindex.nHeight;
                 pindexNew->nFile          = diskindex.nFile;
@@ -144,24 +229,53 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
                 pindexNew->nNonce         = diskindex.nNonce;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
-
-                // This makes the start very long and disabling this check should not have any practical drawback. It has been so since at least 0.10.2 (2014). So, assume that the disk's PoW data is valid.
-                /*if (!CheckProofOfWork(pindexNew->GetBlockHeader().GetHashForPoW(), pindexNew->nBits, ArithToUint256(pindexNew->nNonce), consensusParams)) {
-                    LogError("%s: CheckProofOfWork failed: %s\n", __func__, pindexNew->ToString());
-                    return false;
-                }*/
-
-                pcursor->Next();
-            } else {
-                LogError("%s: failed to read value\n", __func__);
-                return false;
             }
-        } else {
-            break;
+        }
+    }};
+    std::vector<std::function<bool()>> tasks;
+    tasks.reserve(range_count);
+    for (size_t range{0}; range < range_count; range++) {
+        tasks.emplace_back([&, first_byte{range*256/range_count}, end_byte{(range + 1)*256/range_count}] {
+            // Also when read_range throws, so the waiting thread does not wait forever. The exception is then rethrown by the latter from the future of the task.
+            const ScopeExit task_end{[&] {
+                WITH_LOCK(batches_mutex, running_tasks--);
+                batches_cv.notify_one();
+            }};
+            return read_range(first_byte, end_byte);
+        });
+    }
+    if (pool) {
+        if (auto futures{pool->Submit(std::move(tasks))}) {
+            const auto wait_batches{[&](bool insert) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+                while (true) {
+                    {
+                        WAIT_LOCK(batches_mutex, lock);
+                        batches_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(batches_mutex) { return !batches.empty() || running_tasks == 0; });
+                        if (batches.empty()) break;
+                        if (!insert) batches.clear();
+                    }
+                    if (insert) insert_batches();
+                }
+            }};
+            try {
+                // Insert the batches as they come until all the tasks are done
+                wait_batches(/*insert=*/true);
+            } catch (...) {
+                // The tasks reference this frame, so they must be done before leaving it
+                wait_batches(/*insert=*/false);
+                throw;
+            }
+            bool success{true};
+            for (auto& future : *futures) success &= future.get();
+            return success;
         }
     }
-
-    return true;
+    // The tasks were not consumed, run them here
+    return std::ranges::all_of(tasks, [&](const std::function<bool()>& task) {
+        const bool success{task()};
+        insert_batches();
+        return success;
+    });
 }
 
 std::string CBlockFileInfo::ToString() const
@@ -171,6 +285,10 @@ std::string CBlockFileInfo::ToString() const
 } // namespace kernel
 
 namespace node {
+/** Maximum number of block files mapped at once, 2 GiB of address space with the default block file size. */
+static constexpr size_t MAX_BLOCK_FILE_MAPPINGS{16};
+/** Amount of block data read ahead when the blocks of a mapped block file are read sequentially. */
+static constexpr size_t BLOCK_FILE_READAHEAD{16_MiB};
 
 bool CBlockIndexWorkComparator::operator()(const CBlockIndex* pa, const CBlockIndex* pb) const
 {
@@ -429,8 +547,13 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
 
 bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
 {
+    ThreadPool pool{"blkidxload"};
+    if (const int workers{std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0, MAX_BLOCK_INDEX_LOAD_WORKERS)}; workers > 0) {
+        pool.Start(workers);
+    }
+    ThreadPool* const maybe_pool{pool.WorkersCount() > 0 ? &pool : nullptr};
     if (!m_block_tree_db->LoadBlockIndexGuts(
-            GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
+            GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt, maybe_pool)) {
         return false;
     }
 
@@ -459,9 +582,33 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
     Assert(m_snapshot_height.has_value() == snapshot_blockhash.has_value());
 
     // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
+    // The heights are bounded by the number of entries, so a counting sort replaces the comparison one
+    std::vector<CBlockIndex*> vSortedByHeight(m_block_index.size());
+    {
+        std::vector<size_t> heightStarts(m_block_index.size() + 1, 0);
+        for (const auto& [_, block_index] : m_block_index) {
+            if (block_index.nHeight < 0 || static_cast<size_t>(block_index.nHeight) >= m_block_index.size()) {
+                LogError("%s: block index entry %s has an invalid height %d\n", __func__, block_index.GetBlockHash().ToString(), block_index.nHeight);
+                return false;
+            }
+            heightStarts[block_index.nHeight + 1]++;
+        }
+        std::partial_sum(heightStarts.begin(), heightStarts.end(), heightStarts.begin());
+        for (auto& [_, block_index] : m_block_index)
+            vSortedByHeight[heightStarts[block_index.nHeight]++] = &block_index;
+    }
+
+    // The proofs of the blocks are independent, so they are computed in parallel, and stored in nChainWork until the sequential prefix sum below
+    const size_t proofChunks{maybe_pool ? (pool.WorkersCount() + 1)*4 : 1};
+    std::vector<std::function<bool()>> proofTasks;
+    for (size_t chunk{0}; chunk < proofChunks; chunk++) {
+        proofTasks.emplace_back([&vSortedByHeight, begin{chunk*vSortedByHeight.size()/proofChunks}, end{(chunk + 1)*vSortedByHeight.size()/proofChunks}] {
+            for (size_t i{begin}; i < end; i++)
+                vSortedByHeight[i]->nChainWork = GetBlockProof(*vSortedByHeight[i]);
+            return true;
+        });
+    }
+    RunBlockIndexLoadTasks(maybe_pool, std::move(proofTasks));
 
     CBlockIndex* previous_index{nullptr};
     for (CBlockIndex* pindex : vSortedByHeight) {
@@ -471,7 +618,8 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
             return false;
         }
         previous_index = pindex;
-        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+        if (pindex->pprev)
+            pindex->nChainWork += pindex->pprev->nChainWork;
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
 
         // We can link the chain of blocks for which we've received transactions at some point, or
@@ -769,6 +917,8 @@ bool BlockManager::FlushBlockFile(int blockfile_num, bool fFinalize, bool finali
     assert(static_cast<int>(m_blockfile_info.size()) > blockfile_num);
 
     FlatFilePos block_pos_old(blockfile_num, m_blockfile_info[blockfile_num].nSize);
+    // Finalizing truncates the block file, do not keep a mapping beyond its end
+    if (fFinalize) UnmapBlockFile(blockfile_num);
     if (!m_block_file_seq.Flush(block_pos_old, fFinalize)) {
         m_opts.notifications.flushError(_("Flushing block file to disk failed. This is likely the result of an I/O error."));
         success = false;
@@ -821,6 +971,7 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
+        UnmapBlockFile(*it);
         const bool removed_blockfile{fs::remove(m_block_file_seq.FileName(pos), ec)};
         const bool removed_undofile{fs::remove(m_undo_file_seq.FileName(pos), ec)};
         if (removed_blockfile || removed_undofile) {
@@ -1048,32 +1199,48 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const
+bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool check_pow) const
 {
     block.SetNull();
 
-    // Open history file to read
-    const auto block_data{ReadRawBlock(pos)};
-    if (!block_data) {
-        return false;
-    }
-
     try {
-        // Read block
-        SpanReader{*block_data} >> TX_WITH_WITNESS(block);
+        if (m_use_mmap) {
+            const auto mapped{MapRawBlock(pos, std::nullopt)};
+            if (!mapped) {
+                return false;
+            }
+            if (!m_obfuscation) {
+                // Deserialize straight from the mapping
+                SpanReader{mapped->data} >> TX_WITH_WITNESS(block);
+            } else {
+                // De-obfuscate in a buffer reused by the reads of this thread
+                static thread_local std::vector<std::byte> buffer;
+                buffer.assign(mapped->data.begin(), mapped->data.end());
+                m_obfuscation(buffer, mapped->file_offset);
+                SpanReader{buffer} >> TX_WITH_WITNESS(block);
+            }
+        } else {
+            // Open history file to read
+            const auto block_data{ReadRawBlock(pos)};
+            if (!block_data) {
+                return false;
+            }
+            // Read block
+            SpanReader{*block_data} >> TX_WITH_WITNESS(block);
+        }
     } catch (const std::exception& e) {
         LogError("Deserialize or I/O error - %s at %s while reading block", e.what(), pos.ToString());
         return false;
     }
 
-    const auto block_hash{block.GetHash()}, block_hash_pow{block.GetHashForPoW()};
+    const auto block_hash{block.GetHash()};
 
     // Check the header
-    // This makes some operations like wallet rescanning unreasonably long, and disabling this check should not have any practical drawback. So, assume that the disk's PoW data is valid.
-    /*if (!CheckProofOfWork(block_hash_pow, block.nBits, ArithToUint256(block.nNonce), GetConsensus())) {
+    // If the Block is expected to be one from the Block Index, the Hash check below is enough since the PoW of its Header was verified when it was accepted.
+    if (!expected_hash && check_pow && !CheckProofOfWork(block.GetHashForPoW(), block.nBits, ArithToUint256(block.nNonce), GetConsensus())) {
         LogError("Errors in block header at %s while reading block", pos.ToString());
         return false;
-    }*/
+    }
 
     if (expected_hash && block_hash != *expected_hash) {
         LogError("GetHash() doesn't match index at %s while reading block (%s != %s)",
@@ -1099,6 +1266,15 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
         LogError("Failed for %s while reading raw block storage header", pos.ToString());
         return util::Unexpected{ReadRawError::IO};
     }
+    if (m_use_mmap) {
+        const auto mapped{MapRawBlock(pos, block_part)};
+        if (!mapped) {
+            return util::Unexpected{mapped.error()};
+        }
+        std::vector<std::byte> data(mapped->data.begin(), mapped->data.end());
+        m_obfuscation(data, mapped->file_offset);
+        return data;
+    }
     AutoFile filein{OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
     if (filein.IsNull()) {
         LogError("OpenBlockFile failed for %s while reading raw block", pos.ToString());
@@ -1141,6 +1317,92 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
     }
 }
 
+util::Expected<BlockManager::MappedBlock, ReadRawError> BlockManager::MapRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+{
+    if (pos.nPos < STORAGE_HEADER_BYTES) {
+        LogError("Failed for %s while reading raw block storage header", pos.ToString());
+        return util::Unexpected{ReadRawError::IO};
+    }
+    const size_t header_pos{pos.nPos - STORAGE_HEADER_BYTES};
+    bool sequential{false};
+    // The last block file grows as blocks are written, so it may have to be mapped again, to read the storage header and then the block
+    const auto map_file{[&](size_t min_size) EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex) -> std::shared_ptr<const MappedFile> {
+        LOCK(m_block_file_mappings_mutex);
+        auto it{m_block_file_mappings.find(pos.nFile)};
+        if (it == m_block_file_mappings.end() || it->second.file->Data().size() < min_size) {
+            std::shared_ptr<const MappedFile> mapped{MappedFile::Open(m_block_file_seq.FileName(pos))};
+            if (!mapped) {
+                LogError("Mapping failed for %s while reading raw block", pos.ToString());
+                return nullptr;
+            }
+            if (it == m_block_file_mappings.end() && m_block_file_mappings.size() >= MAX_BLOCK_FILE_MAPPINGS) {
+                m_block_file_mappings.erase(std::min_element(m_block_file_mappings.begin(), m_block_file_mappings.end(), [](const auto& a, const auto& b) {
+                    return a.second.last_use < b.second.last_use;
+                }));
+            }
+            it = m_block_file_mappings.insert_or_assign(pos.nFile, BlockFileMapping{std::move(mapped), 0, 0}).first;
+        }
+        it->second.last_use = ++m_block_file_mappings_uses;
+        sequential = it->second.next_read_pos == header_pos;
+        return it->second.file;
+    }};
+    std::shared_ptr<const MappedFile> file{map_file(pos.nPos)};
+    if (!file) return util::Unexpected{ReadRawError::IO};
+
+    std::span<const std::byte> data{file->Data()};
+    if (data.size() < pos.nPos) {
+        LogError("Block file too small for %s while reading raw block storage header", pos.ToString());
+        return util::Unexpected{ReadRawError::IO};
+    }
+    std::array<std::byte, STORAGE_HEADER_BYTES> header;
+    std::ranges::copy(data.subspan(header_pos, STORAGE_HEADER_BYTES), header.begin());
+    m_obfuscation(header, header_pos);
+    MessageStartChars blk_start;
+    unsigned int blk_size;
+    SpanReader{header} >> blk_start >> blk_size;
+
+    if (blk_start != GetParams().MessageStart()) {
+        LogError("Block magic mismatch for %s: %s versus expected %s while reading raw block",
+            pos.ToString(), HexStr(blk_start), HexStr(GetParams().MessageStart()));
+        return util::Unexpected{ReadRawError::IO};
+    }
+    if (blk_size <= MAX_SIZE && blk_size > data.size() - pos.nPos) {
+        // The block was written past the end of the mapping, in a chunk allocated since
+        file = map_file(pos.nPos + blk_size);
+        if (!file) return util::Unexpected{ReadRawError::IO};
+        data = file->Data();
+    }
+    if (blk_size > MAX_SIZE || blk_size > data.size() - pos.nPos) {
+        LogError("Block data is larger than maximum deserialization size or block file for %s: %s versus %s while reading raw block",
+            pos.ToString(), blk_size, std::min<size_t>(MAX_SIZE, data.size() - pos.nPos));
+        return util::Unexpected{ReadRawError::IO};
+    }
+
+    {
+        LOCK(m_block_file_mappings_mutex);
+        const auto it{m_block_file_mappings.find(pos.nFile)};
+        if (it != m_block_file_mappings.end() && it->second.file == file) it->second.next_read_pos = pos.nPos + blk_size;
+    }
+    if (sequential) file->WillNeed(pos.nPos + blk_size, BLOCK_FILE_READAHEAD);
+
+    size_t offset{0};
+    if (block_part) {
+        const auto [part_offset, part_size]{*block_part};
+        if (part_size == 0 || SaturatingAdd(part_offset, part_size) > blk_size) {
+            return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
+        }
+        offset = part_offset;
+        blk_size = part_size;
+    }
+    return MappedBlock{std::move(file), data.subspan(pos.nPos + offset, blk_size), pos.nPos + offset};
+}
+
+void BlockManager::UnmapBlockFile(int file_num) const
+{
+    // Readers still holding the mapping keep it alive until they are done
+    WITH_LOCK(m_block_file_mappings_mutex, m_block_file_mappings.erase(file_num));
+}
+
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
 {
     const unsigned int block_size{static_cast<unsigned int>(GetSerializeSize(TX_WITH_WITNESS(block)))};
@@ -1234,6 +1496,8 @@ static auto InitBlocksdirXorKey(const BlockManager::Options& opts)
 BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
     : m_prune_mode{opts.prune_target > 0},
       m_obfuscation{InitBlocksdirXorKey(opts)},
+      // The block files would use too much of the address space of 32 bit platforms
+      m_use_mmap{opts.use_mmap && MappedFile::SUPPORTED && sizeof(void*) >= 8},
       m_opts{std::move(opts)},
       m_block_file_seq{FlatFileSeq{m_opts.blocks_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE}},
       m_undo_file_seq{FlatFileSeq{m_opts.blocks_dir, "rev", UNDOFILE_CHUNK_SIZE}},
@@ -24,6 +24,7 @@
 #include <util/expected.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/mappedfile.h>
 #include <util/obfuscation.h>
 
 #include <algorithm>
@@ -48,6 +49,7 @@ class BlockValidationState;
 class CBlockUndo;
 class Chainstate;
 class ChainstateManager;
+class ThreadPool;
 namespace Consensus {
 struct Params;
 }
@@ -109,7 +111,11 @@ public:
     void ReadReindexing(bool& fReindexing);
     void WriteFlag(const std::string& name, bool fValue);
     bool ReadFlag(const std::string& name, bool& fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
+    /**
+     * Load the block index entries with insertBlockIndex. If a started pool is given, ranges of hashes are read
+     * and checked in parallel by its workers and the calling thread, which insert their entries by batches.
+     */
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt, ThreadPool* pool = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
 } // namespace kernel
@@ -292,6 +298,33 @@ private:
 
     const Obfuscation m_obfuscation;
 
+    //! Whether the block files are read through memory mappings, see BlockManagerOpts::use_mmap
+    const bool m_use_mmap;
+
+    /** Mapping of a block file, for reads when m_use_mmap is set. */
+    struct BlockFileMapping {
+        std::shared_ptr<const MappedFile> file;
+        uint64_t last_use;
+        //! File offset following the last read block, to detect sequential scans
+        size_t next_read_pos;
+    };
+    mutable Mutex m_block_file_mappings_mutex;
+    mutable std::map<int, BlockFileMapping> m_block_file_mappings GUARDED_BY(m_block_file_mappings_mutex);
+    mutable uint64_t m_block_file_mappings_uses GUARDED_BY(m_block_file_mappings_mutex){0};
+
+    /** Block data (or part of it) within the mapping of its block file, which is kept alive by this. The data is still obfuscated. */
+    struct MappedBlock {
+        std::shared_ptr<const MappedFile> file;
+        std::span<const std::byte> data;
+        //! Offset of data in the block file, for the de-obfuscation
+        size_t file_offset;
+    };
+    /** Locate the block data at pos in the mapping of its block file, checking its storage header as ReadRawBlock. */
+    util::Expected<MappedBlock, ReadRawError> MapRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex);
+    /** Drop the mapping of a block file which is truncated or deleted. */
+    void UnmapBlockFile(int file_num) const EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex);
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -477,9 +510,12 @@ public:
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
     /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
-    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+    //! Without an expected_hash, the PoW of the block is checked, unless check_pow is false because the caller checks it anyway
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool check_pow = true) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex);
+    bool ReadBlock(CBlock& block, const CBlockIndex& index) const EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex);
+    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_block_file_mappings_mutex);
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
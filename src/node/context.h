@@ -44,6 +44,7 @@ class SignalInterrupt;
 
 namespace node {
 class KernelNotifications;
+class MiningPowerEstimator;
 class Warnings;
 
 //! NodeContext struct containing references to chain state and connection
@@ -71,6 +72,7 @@ struct NodeContext {
     std::unique_ptr<CTxMemPool> mempool;
     std::unique_ptr<const NetGroupManager> netgroupman;
     std::unique_ptr<CBlockPolicyEstimator> fee_estimator;
+    std::unique_ptr<MiningPowerEstimator> mining_power_estimator;
     std::unique_ptr<PeerManager> peerman;
     std::unique_ptr<TorController> tor_controller;
     std::unique_ptr<ChainstateManager> chainman;
@@ -6,13 +6,68 @@
 
 #include <common/args.h>
 #include <dbwrapper.h>
+#include <tinyformat.h>
+#include <util/byte_units.h>
+#include <util/result.h>
+#include <util/strencodings.h>
+#include <util/translation.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
 
 namespace node {
-void ReadDatabaseArgs(const ArgsManager& args, DBOptions& options)
+namespace {
+/**
+ * Read a tuning option, given as "<n>" for every database or as "<db>:<n>"
+ * for one of them, which takes precedence. The value is left unset when
+ * the option does not apply to the database.
+ */
+util::Result<void> ReadTuningArg(const ArgsManager& args, const std::string& name, std::string_view db_name, int64_t min, int64_t max, std::optional<int64_t>& value)
+{
+    std::optional<int64_t> all, specific;
+    for (const std::string& arg : args.GetArgs(name)) {
+        const size_t colon{arg.find(':')};
+        const std::string_view db{colon == std::string::npos ? std::string_view{} : std::string_view{arg}.substr(0, colon)};
+        if (!db.empty() && std::ranges::find(DATABASE_NAMES, db) == DATABASE_NAMES.end()) {
+            return util::Error{strprintf(_("Unknown database %s in %s=%s."), db, name, arg)};
+        }
+        const auto parsed{ToIntegral<int64_t>(colon == std::string::npos ? arg : std::string_view{arg}.substr(colon + 1))};
+        if (!parsed || *parsed < min || *parsed > max) {
+            return util::Error{strprintf(_("Invalid %s=%s, the value must be between %d and %d."), name, arg, min, max)};
+        }
+        if (db.empty()) {
+            all = *parsed;
+        } else if (db == db_name) {
+            specific = *parsed;
+        }
+    }
+    value = specific ? specific : all;
+    return {};
+}
+} // namespace
+
+util::Result<void> ReadDatabaseArgs(const ArgsManager& args, DBOptions& options, std::string_view db_name)
 {
-    // Settings here apply to all databases (chainstate, blocks, and index
-    // databases), but it'd be easy to parse database-specific options by adding
-    // a database_type string or enum parameter to this function.
     if (auto value = args.GetBoolArg("-forcecompactdb")) options.force_compact = *value;
+    if (auto value = args.GetArg("-dbengine")) {
+        // Invalid values are rejected by AppInitParameterInteraction
+        if (auto engine = DBEngineTypeFromString(*value)) options.engine = *engine;
+    }
+
+    std::optional<int64_t> bloom_bits, write_buffer_mib, block_cache_mib, max_file_mib;
+    const int64_t max_mib{int64_t(std::numeric_limits<size_t>::max() / 1_MiB)};
+    if (auto result{ReadTuningArg(args, "-dbbloombits", db_name, 0, 32, bloom_bits)}; !result) return result;
+    if (auto result{ReadTuningArg(args, "-dbwritebuffersize", db_name, 1, 1024, write_buffer_mib)}; !result) return result;
+    if (auto result{ReadTuningArg(args, "-dbblockcachesize", db_name, 1, max_mib, block_cache_mib)}; !result) return result;
+    if (auto result{ReadTuningArg(args, "-dbmaxfilesize", db_name, 1, 1024, max_file_mib)}; !result) return result;
+    if (bloom_bits) options.bloom_bits = *bloom_bits;
+    if (write_buffer_mib) options.write_buffer_size = *write_buffer_mib * 1_MiB;
+    if (block_cache_mib) options.block_cache_size = *block_cache_mib * 1_MiB;
+    if (max_file_mib) options.max_file_size = *max_file_mib * 1_MiB;
+    return {};
 }
 } // namespace node
@@ -5,11 +5,19 @@
 #ifndef BITCOIN_NODE_DATABASE_ARGS_H
 #define BITCOIN_NODE_DATABASE_ARGS_H
 
+#include <util/result.h>
+
+#include <array>
+#include <string_view>
+
 class ArgsManager;
 struct DBOptions;
 
 namespace node {
-void ReadDatabaseArgs(const ArgsManager& args, DBOptions& options);
+//! Names of the databases in the tuning options, the indexes sharing theirs.
+inline constexpr std::array<std::string_view, 3> DATABASE_NAMES{"chainstate", "blockindex", "indexes"};
+
+util::Result<void> ReadDatabaseArgs(const ArgsManager& args, DBOptions& options, std::string_view db_name);
 } // namespace node
 
 #endif // BITCOIN_NODE_DATABASE_ARGS_H
@@ -35,6 +35,7 @@
 #include <net_types.h>
 #include <netaddress.h>
 #include <netbase.h>
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/coin.h>
 #include <node/context.h>
@@ -84,6 +85,7 @@
 #include <utility>
 #include <vector>
 
+using interfaces::BlockReader;
 using interfaces::BlockRef;
 using interfaces::BlockTemplate;
 using interfaces::BlockTip;
@@ -464,6 +466,20 @@ bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<Rec
     return true;
 }
 
+class BlockReaderImpl : public BlockReader
+{
+public:
+    explicit BlockReaderImpl(ChainstateManager& chainman) : m_chainman{chainman}, m_prefetcher{chainman.m_blockman} {}
+    std::shared_ptr<const CBlock> readBlock(const uint256& hash) override
+    {
+        const CBlockIndex* index{WITH_LOCK(::cs_main, return m_chainman.m_blockman.LookupBlockIndex(hash))};
+        if (!index) return nullptr;
+        return m_prefetcher.Read(*index, [this](const CBlockIndex& block) { return WITH_LOCK(::cs_main, return m_chainman.ActiveChain().Next(block)); });
+    }
+    ChainstateManager& m_chainman;
+    BlockPrefetcher m_prefetcher;
+};
+
 class NotificationsProxy : public CValidationInterface
 {
 public:
@@ -603,6 +619,10 @@ public:
         WAIT_LOCK(cs_main, lock);
         return FillBlock(chainman().m_blockman.LookupBlockIndex(hash), block, lock, chainman().ActiveChain(), chainman().m_blockman);
     }
+    std::unique_ptr<BlockReader> makeBlockReader() override
+    {
+        return std::make_unique<BlockReaderImpl>(chainman());
+    }
     bool findFirstBlockWithTimeAndHeight(int64_t min_time, int min_height, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -917,7 +937,7 @@ public:
         return TransactionMerklePath(m_block_template->block, 0);
     }
 
-    bool submitSolution(uint32_t version, uint32_t timestamp, uint32_t nonce, CTransactionRef coinbase) override
+    bool submitSolution(uint32_t version, uint32_t timestamp, const uint256& nonce, CTransactionRef coinbase) override
     {
         AddMerkleRootAndCoinbase(m_block_template->block, std::move(coinbase), version, timestamp, nonce);
         std::string reason;
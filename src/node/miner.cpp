@@ -6,9 +6,11 @@
 
 #include <node/miner.h>
 
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
@@ -43,6 +45,7 @@
 #include <versionbits.h>
 
 #include <algorithm>
+#include <atomic>
 #include <compare>
 #include <condition_variable>
 #include <cstddef>
@@ -51,6 +54,7 @@
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 
 namespace node {
@@ -321,7 +325,7 @@ void BlockAssembler::addChunks()
     }
 }
 
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce)
+void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, const uint256& nonce)
 {
     if (block.vtx.size() == 0) {
         block.vtx.emplace_back(coinbase);
@@ -330,7 +334,7 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
     }
     block.nVersion = version;
     block.nTime = timestamp;
-    block.nNonce = nonce;
+    block.nNonce = UintToArith256(nonce);
     block.hashMerkleRoot = BlockMerkleRoot(block);
 
     // Reset cached checks
@@ -559,4 +563,94 @@ std::optional<BlockRef> WaitTipChanged(ChainstateManager& chainman, KernelNotifi
     return GetTip(chainman);
 }
 
+
+//! Number of candidates sieved at once by a mining thread
+static constexpr uint64_t MINING_SEGMENT_SIZE{1 << 15};
+//! Number of odd Primes used to sieve the mining candidates
+static constexpr size_t MINING_SIEVE_PRIMES{4096};
+
+bool MineProofOfWork(CBlockHeader& header, const Consensus::Params& params, uint64_t& max_tries, int threads, const util::SignalInterrupt& interrupt)
+{
+    header.nNonce = 2; // PoW Version 1, Primorial Number 0 (Primorial = 1), Parameters at 0. The Target Offset is then 1 + the Primorial Offset.
+    const uint256 hash(header.GetHashForPoW());
+    const std::optional<uint32_t> trailingZeros(DeriveTrailingZeros(header.nBits, 0, 1, params.nBitsMin));
+    const std::optional<mpz_class> target(DeriveTarget(hash, header.nBits, 0, 1, params.nBitsMin));
+    if (!trailingZeros || !target || *trailingZeros == 0) {
+        max_tries = 0;
+        return false;
+    }
+    // The Target Offset 1 + 2k must be below 2^trailingZeros
+    const uint64_t candidates(*trailingZeros > 64U ? max_tries : std::min(max_tries, uint64_t{1} << (*trailingZeros - 1U)));
+    const mpz_class base(*target + 1);
+
+    // For each Pattern, the candidates k such that base + 2k + offset is divisible by a sieving Prime p are the k = root mod p, with one root per Pattern element
+    struct SieveRoot {
+        uint32_t prime;
+        uint32_t root;
+    };
+    const std::vector<std::vector<int32_t>>& patterns(params.powAcceptedPatterns);
+    std::vector<std::vector<SieveRoot>> sieveRoots(patterns.size());
+    for (size_t i(1) ; i <= MINING_SIEVE_PRIMES ; i++) {
+        const uint32_t p(primeTable[i]);
+        const uint64_t baseModP(mpz_fdiv_ui(base.get_mpz_t(), p)), halfModP((p + 1)/2);
+        for (size_t j(0) ; j < patterns.size() ; j++) {
+            uint64_t offset(0);
+            for (const int32_t patternOffset : patterns[j]) {
+                offset += patternOffset;
+                sieveRoots[j].push_back({p, static_cast<uint32_t>((p - (baseModP + offset) % p) % p*halfModP % p)});
+            }
+        }
+    }
+
+    // The segments are handed out in increasing order, so once a solution is found, only the segments before it must still be completed
+    std::atomic<uint64_t> nextSegment{0}, solution{candidates};
+    const auto mine([&]() {
+        std::vector<std::vector<bool>> composite(patterns.size(), std::vector<bool>(MINING_SEGMENT_SIZE));
+        mpz_class n;
+        while (!interrupt) {
+            const uint64_t start(nextSegment++*MINING_SEGMENT_SIZE);
+            if (start >= solution)
+                break;
+            const uint64_t size(std::min(MINING_SEGMENT_SIZE, solution - start));
+            for (size_t j(0) ; j < patterns.size() ; j++) {
+                std::fill(composite[j].begin(), composite[j].end(), false);
+                for (const SieveRoot& sieveRoot : sieveRoots[j]) {
+                    for (uint64_t k((sieveRoot.root + sieveRoot.prime - start % sieveRoot.prime) % sieveRoot.prime) ; k < size ; k += sieveRoot.prime)
+                        composite[j][k] = true;
+                }
+            }
+            for (uint64_t k(0) ; k < size && start + k < solution ; k++) {
+                if (std::all_of(composite.begin(), composite.end(), [k](const std::vector<bool>& patternComposite) {return patternComposite[k];}))
+                    continue;
+                const uint64_t candidate(start + k);
+                mpz_import(n.get_mpz_t(), 1, -1, sizeof(candidate), 0, 0, &candidate);
+                n <<= 1;
+                n += base;
+                if (CheckConstellations(n, patterns)) {
+                    uint64_t currentSolution(solution);
+                    while (start + k < currentSolution && !solution.compare_exchange_weak(currentSolution, start + k));
+                    break;
+                }
+            }
+        }
+    });
+    if (threads <= 0)
+        threads = GetNumCores();
+    std::vector<std::thread> workers;
+    for (int i(1) ; i < threads ; i++)
+        workers.emplace_back(mine);
+    mine();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    if (interrupt)
+        return false;
+    if (solution == candidates) {
+        max_tries -= candidates;
+        return false;
+    }
+    header.nNonce += arith_uint256(solution) << 17; // Primorial Offset 2k
+    max_tries -= solution;
+    return true;
+}
 } // namespace node
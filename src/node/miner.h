@@ -33,6 +33,9 @@ class uint256;
 namespace interfaces {
 struct BlockRef;
 } // namespace interfaces
+namespace util {
+class SignalInterrupt;
+} // namespace util
 
 using interfaces::BlockRef;
 
@@ -121,7 +124,7 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 
 /* Compute the block's merkle root, insert or replace the coinbase transaction and the merkle root into the block */
-void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce);
+void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, const uint256& nonce);
 
 //! Submit a block and capture the validation state via the BlockChecked callback.
 //! Returns whether ProcessNewBlock accepted the block.
@@ -170,6 +173,25 @@ std::optional<BlockRef> WaitTipChanged(ChainstateManager& chainman, KernelNotifi
  * @returns false if interrupted.
  */
 bool CooldownIfHeadersAhead(ChainstateManager& chainman, KernelNotifications& kernel_notifications, const BlockRef& last_tip, bool& interrupt_mining);
+
+/** Default number of threads used to search Proofs of Work for the generate RPCs, 0 meaning one per core */
+static constexpr int DEFAULT_GENERATE_THREADS{1};
+
+/**
+ * Search a Proof of Work for the Header in its Target window, like a brute force search from the Target would: with PoW Version 1 and Primorial Number 0,
+ * the candidates are Target + 1 + 2k, encoded in nNonce as the Primorial Offset 2k. The candidates are sieved by small Primes for all the accepted Patterns
+ * by segments, shared between the threads, then the remaining ones are checked in increasing order, so the smallest solution is always returned regardless of the number of threads.
+ *
+ * @param[in,out] header     the Header whose nNonce is set if a Proof of Work is found
+ * @param[in]     params     Consensus parameters, for the accepted Patterns and the minimum Difficulty
+ * @param[in,out] max_tries  the number of candidates to search, decreased by the number of candidates tried, those before the solution if one was found,
+ *                           or set to 0 if the Target cannot be derived
+ * @param[in]     threads    the number of threads to use, including the calling one, 0 meaning one per core
+ * @param[in]     interrupt  stops the search when set
+ *
+ * @returns whether a Proof of Work was found
+ */
+bool MineProofOfWork(CBlockHeader& header, const Consensus::Params& params, uint64_t& max_tries, int threads, const util::SignalInterrupt& interrupt);
 } // namespace node
 
 #endif // BITCOIN_NODE_MINER_H
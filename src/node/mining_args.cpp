@@ -6,8 +6,10 @@
 
 #include <common/args.h>
 #include <common/messages.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
+#include <node/miner.h>
 #include <node/mining_types.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
@@ -16,6 +18,7 @@
 #include <util/result.h>
 #include <util/translation.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -96,4 +99,12 @@ BlockCreateOptions MergeMiningOptions(BlockCreateOptions x, const BlockCreateOpt
     return x;
 }
 
+int ReadGenerateThreads(const ArgsManager& args)
+{
+    // More threads than the hardware runs at once would only compete for the cores
+    const int64_t hardware_threads{std::max(GetNumCores(), 1)};
+    const int64_t threads{args.GetIntArg("-genthreads", DEFAULT_GENERATE_THREADS)};
+    return threads <= 0 ? hardware_threads : std::min(threads, hardware_threads);
+}
+
 } // namespace node
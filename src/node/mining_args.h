@@ -32,6 +32,12 @@ static const bool DEFAULT_PRINT_MODIFIED_FEE = false;
  */
 [[nodiscard]] BlockCreateOptions MergeMiningOptions(BlockCreateOptions x, const BlockCreateOptions& y);
 
+/**
+ * Read the number of threads used to search Proofs of Work for the generate
+ * RPCs from -genthreads, clamped to the number of hardware threads.
+ */
+[[nodiscard]] int ReadGenerateThreads(const ArgsManager& args);
+
 } // namespace node
 
 #endif // BITCOIN_NODE_MINING_ARGS_H
@@ -0,0 +1,154 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/mining_power.h>
+
+#include <chain.h>
+#include <consensus/params.h>
+#include <kernel/types.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace node {
+double MiningPowerEstimator::Estimate(const CBlockIndex& tip, int height, int lookup)
+{
+    Assume(lookup > 0 && height <= tip.nHeight);
+    LOCK(m_mutex);
+    Sync(tip);
+    const int end{height < 0 ? tip.nHeight : height};
+    if (end == 0)
+        return 0.;
+    // If lookup is larger than chain, then set it to chain length.
+    lookup = std::min(lookup, end);
+    const auto [min_time, max_time]{GetTimeRange(end - lookup, end + 1)};
+    // In case there's a situation where minTime == maxTime, we don't want a divide by zero exception.
+    if (min_time == max_time)
+        return 0.;
+    return m_params.nPowTargetSpacing*GetWork(end - lookup, end)/(max_time - min_time);
+}
+
+void MiningPowerEstimator::BlockConnected(const kernel::ChainstateRole& role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    // Blocks of a background chainstate are not at the tip
+    if (role.historical)
+        return;
+    LOCK(m_mutex);
+    // Until the first query, there is nothing to keep up to date
+    if (!m_times.empty())
+        Sync(*pindex);
+}
+
+void MiningPowerEstimator::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    LOCK(m_mutex);
+    // The block may have been dropped already by a query that caught up with a reorganization
+    if (pindex->nHeight == Height() && pindex->GetBlockHash() == m_tip_hash)
+        Truncate(pindex->pprev);
+}
+
+bool MiningPowerEstimator::IsTracked(const CBlockIndex& block) const
+{
+    if (block.nHeight > Height())
+        return false;
+    if (block.nHeight == Height())
+        return block.GetBlockHash() == m_tip_hash;
+    if ((block.nHeight + 1) % CHUNK_SIZE == 0)
+        return block.GetBlockHash() == m_chunk_hashes[block.nHeight/CHUNK_SIZE];
+    return false;
+}
+
+void MiningPowerEstimator::Append(const CBlockIndex& block)
+{
+    m_times.push_back(block.GetBlockTime());
+    m_work.push_back((m_work.empty() ? 0. : m_work.back()) + GetNormalizedWork(block));
+    m_tip_hash = block.GetBlockHash();
+    if (m_times.size() % CHUNK_SIZE != 0)
+        return;
+    m_chunk_hashes.push_back(m_tip_hash);
+    const int chunks{static_cast<int>(m_times.size()/CHUNK_SIZE)};
+    if (m_time_ranges.empty())
+        m_time_ranges.emplace_back();
+    // The new chunk is not in the sparse table yet, so it is not looked up there
+    m_time_ranges[0].push_back(ScanTimeRange((chunks - 1)*CHUNK_SIZE, chunks*CHUNK_SIZE));
+    for (int level{1}; (1 << level) <= chunks; level++) {
+        if (level == std::ssize(m_time_ranges))
+            m_time_ranges.emplace_back();
+        const std::vector<TimeRange>& previous_level(m_time_ranges[level - 1]);
+        const TimeRange& left(previous_level[chunks - (1 << level)]), right(previous_level[chunks - (1 << (level - 1))]);
+        m_time_ranges[level].push_back({std::min(left.min, right.min), std::max(left.max, right.max)});
+    }
+}
+
+void MiningPowerEstimator::Truncate(const CBlockIndex* tip)
+{
+    const int height{tip == nullptr ? 0 : tip->nHeight + 1};
+    m_times.resize(height);
+    m_work.resize(height);
+    m_tip_hash = tip == nullptr ? uint256{} : tip->GetBlockHash();
+    const int chunks{height/CHUNK_SIZE};
+    m_chunk_hashes.resize(chunks);
+    for (int level{0}; level < std::ssize(m_time_ranges); level++)
+        m_time_ranges[level].resize(std::max(chunks - (1 << level) + 1, 0));
+    while (!m_time_ranges.empty() && m_time_ranges.back().empty())
+        m_time_ranges.pop_back();
+}
+
+void MiningPowerEstimator::Sync(const CBlockIndex& tip)
+{
+    // The heights, timestamps, Difficulties, hashes and parents of block indexes never change, so they are read without cs_main
+    std::vector<const CBlockIndex*> missing_blocks;
+    const CBlockIndex* pindex(&tip);
+    while (pindex != nullptr && !IsTracked(*pindex)) {
+        missing_blocks.push_back(pindex);
+        pindex = pindex->pprev;
+    }
+    if (missing_blocks.empty())
+        return;
+    Truncate(pindex);
+    for (auto it(missing_blocks.rbegin()); it != missing_blocks.rend(); it++)
+        Append(**it);
+}
+
+MiningPowerEstimator::TimeRange MiningPowerEstimator::ScanTimeRange(int begin, int end) const
+{
+    TimeRange range{std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    for (int height{begin}; height < end; height++) {
+        range.min = std::min(range.min, m_times[height]);
+        range.max = std::max(range.max, m_times[height]);
+    }
+    return range;
+}
+
+MiningPowerEstimator::TimeRange MiningPowerEstimator::GetTimeRange(int begin, int end) const
+{
+    // Only the partial chunks at the ends of the range are scanned, the complete ones in between are covered by two overlapping entries of the sparse table
+    const int first_chunk{(begin + CHUNK_SIZE - 1)/CHUNK_SIZE}, end_chunk{end/CHUNK_SIZE};
+    if (first_chunk >= end_chunk)
+        return ScanTimeRange(begin, end);
+    const int level{static_cast<int>(std::bit_width(static_cast<unsigned int>(end_chunk - first_chunk))) - 1};
+    TimeRange range{ScanTimeRange(begin, first_chunk*CHUNK_SIZE)};
+    for (const TimeRange& other_range : {ScanTimeRange(end_chunk*CHUNK_SIZE, end), m_time_ranges[level][first_chunk], m_time_ranges[level][end_chunk - (1 << level)]}) {
+        range.min = std::min(range.min, other_range.min);
+        range.max = std::max(range.max, other_range.max);
+    }
+    return range;
+}
+
+double MiningPowerEstimator::GetNormalizedWork(const CBlockIndex& block) const
+{
+    // The work d^(l + 2.3) of GetBlockProof, without its truncation to an integer, with the constellation size l changing at Fork 2
+    const double difficulty(m_params.GetPoWVersionAtHeight(block.nHeight) == -1 ? (block.nBits & 0x007FFFFFU) >> 8U : block.nBits/256.),
+                 referenceDifficulty(m_params.nBitsMin/256.);
+    return std::pow(difficulty/referenceDifficulty, m_params.GetConstellationSizeAtHeight(block.nHeight) + 2.3);
+}
+
+double MiningPowerEstimator::GetWork(int begin, int end) const
+{
+    return m_work[end] - m_work[begin];
+}
+} // namespace node
@@ -0,0 +1,93 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_MINING_POWER_H
+#define BITCOIN_NODE_MINING_POWER_H
+
+#include <sync.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+namespace Consensus {
+struct Params;
+} // namespace Consensus
+namespace kernel {
+struct ChainstateRole;
+} // namespace kernel
+
+namespace node {
+/**
+ * Estimates the network mining power over any window of the active chain in constant time.
+ *
+ * The work of a window is the difference of the prefix sums of the normalized work of the blocks
+ * at its ends, and its extreme timestamps come from a sparse table over chunks of blocks. These
+ * tables are copied from the block indexes, whose fields used here never change, so cs_main is
+ * never needed. Nothing is tracked until the first query, which walks the chain of the tip it is
+ * given. Then the tables follow the connected and disconnected blocks from the validation interface,
+ * and queries only catch up with the notifications not delivered yet, so they never use stale data.
+ */
+class MiningPowerEstimator final : public CValidationInterface
+{
+public:
+    explicit MiningPowerEstimator(const Consensus::Params& params) : m_params{params} {}
+
+    /**
+     * Estimate the mining power from the lookup blocks ending at the given height (the tip if -1)
+     * of the chain of tip. It is normalized such that 1 corresponds to finding a minimum difficulty
+     * block every nPowTargetSpacing. The height must not exceed the tip one, and lookup must be positive.
+     */
+    double Estimate(const CBlockIndex& tip, int height, int lookup) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void BlockConnected(const kernel::ChainstateRole& role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    //! Number of blocks of the chunks of the timestamp sparse table
+    static constexpr int CHUNK_SIZE{64};
+
+    struct TimeRange {
+        int64_t min;
+        int64_t max;
+    };
+
+    const Consensus::Params& m_params;
+    Mutex m_mutex;
+    //! Timestamps of the tracked blocks, by height
+    std::vector<int64_t> m_times GUARDED_BY(m_mutex);
+    //! m_work[h] is the sum of the normalized work of the tracked blocks up to height h
+    std::vector<double> m_work GUARDED_BY(m_mutex);
+    //! m_time_ranges[k][c] is the timestamp range of the complete chunks c to c + 2^k - 1
+    std::vector<std::vector<TimeRange>> m_time_ranges GUARDED_BY(m_mutex);
+    //! Hashes of the last blocks of the complete chunks, to find where another chain forks from the tracked one
+    std::vector<uint256> m_chunk_hashes GUARDED_BY(m_mutex);
+    //! Hash of the last tracked block
+    uint256 m_tip_hash GUARDED_BY(m_mutex);
+
+    int Height() const EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return std::ssize(m_times) - 1; }
+    //! Whether the block is known to be tracked, which can only be checked at the tip and at the ends of the chunks
+    bool IsTracked(const CBlockIndex& block) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Append(const CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Stop tracking the blocks above the given one (all of them if nullptr)
+    void Truncate(const CBlockIndex* tip) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Track the chain of tip
+    void Sync(const CBlockIndex& tip) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Timestamp range of the blocks at heights [begin, end), read from each of them
+    TimeRange ScanTimeRange(int begin, int end) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Timestamp range of the blocks at heights [begin, end)
+    TimeRange GetTimeRange(int begin, int end) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Work of the block divided by the one of a minimum Difficulty block
+    double GetNormalizedWork(const CBlockIndex& block) const;
+    //! Sum of the normalized work of the blocks at heights (begin, end]
+    double GetWork(int begin, int end) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_MINING_POWER_H
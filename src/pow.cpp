@@ -10,8 +10,13 @@
 #include <chain.h>
 #include <logging.h>
 #include <primitives/block.h>
+#include <sync.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <array>
 
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params)
 {
@@ -66,7 +71,7 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const Consensus:
 
 unsigned int asert(const uint64_t nBits, int64_t previousSolveTime, int64_t nextHeight, const Consensus::Params& params) {
     const int64_t N(64), // Smoothing Value
-                  cp(10*params.GetPowAcceptedPatternsAtHeight(nextHeight)[0].size() + 23), // Constellation Power * 10
+                  cp(10*params.GetConstellationSizeAtHeight(nextHeight) + 23), // Constellation Power * 10
                   previousDifficulty(nBits); // With the fixed point format, calculations can directly be done on nBits (int64 is used to avoid overflows)
     if (previousSolveTime < -TIMESTAMP_WINDOW)
         previousSolveTime = -TIMESTAMP_WINDOW;
@@ -126,10 +131,10 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
         if (newDifficulty < minDifficulty)
             newDifficulty = minDifficulty;
 
-        std::string newDifficultyStr(newDifficulty.get_str(16));
-        newDifficultyStr = std::string(64U - newDifficultyStr.length(), '0') + newDifficultyStr;
-        arith_uint256 newDifficultyU256(UintToArith256(uint256::FromHex(newDifficultyStr).value()));
-        return newDifficultyU256.GetCompact();
+        uint256 newDifficultyU256;
+        assert(mpz_sizeinbase(newDifficulty.get_mpz_t(), 2) <= 256);
+        mpz_export(newDifficultyU256.begin(), nullptr, -1, sizeof(uint8_t), 0, 0, newDifficulty.get_mpz_t()); // uint256 is stored in little endian byte order
+        return UintToArith256(newDifficultyU256).GetCompact();
     }
 }
 
@@ -157,10 +162,17 @@ std::optional<mpz_class> DeriveTarget(uint256 hash, unsigned int nBits, unsigned
 {
     mpz_class target(256);
     if (powVersion == -1) { // Target = 1 . 00000000 . hash . 00...0 = 2^(D - 1) + H*2^(D – 265)
-        for (int i(0) ; i < 256 ; i++) { // Inverts endianness and bit order inside bytes
-            target <<= 1;
-            target += ((hash.begin()[i/8] >> (i % 8)) & 1);
-        }
+        // The Hash bits are used in the reverse order, which is done by reversing the bit order inside each byte and importing the bytes as Big Endian
+        std::array<uint8_t, 32> reversedHash;
+        std::transform(hash.begin(), hash.end(), reversedHash.begin(), [](uint8_t byte) {
+            byte = ((byte & 0xF0U) >> 4U) | ((byte & 0x0FU) << 4U);
+            byte = ((byte & 0xCCU) >> 2U) | ((byte & 0x33U) << 2U);
+            return static_cast<uint8_t>(((byte & 0xAAU) >> 1U) | ((byte & 0x55U) << 1U));
+        });
+        mpz_class hashGmp;
+        mpz_import(hashGmp.get_mpz_t(), reversedHash.size(), 1, sizeof(uint8_t), 0, 0, reversedHash.data());
+        target <<= 256;
+        target += hashGmp;
     }
     else if (powVersion == 1) { // Here, rather than using 8 zeros, we fill this field with L = round(2^(8 + Df/2^8) - 2^8)
         uint32_t df(nBits & 255U);
@@ -181,17 +193,142 @@ std::optional<mpz_class> DeriveTarget(uint256 hash, unsigned int nBits, unsigned
     return target;
 }
 
-uint32_t CheckConstellation(mpz_class n, std::vector<int32_t> offsets, uint32_t iterations)
+static_assert(GMP_NAIL_BITS == 0, "GMP Nails are not supported");
+
+// Montgomery Reduction of the 2*size Limbs product (destroyed) with minusInverse = -1/m mod 2^GMP_NUMB_BITS. The result is fully reduced.
+static void MontgomeryReduce(mp_limb_t* result, mp_limb_t* product, const mp_limb_t* m, const mp_size_t size, const mp_limb_t minusInverse)
 {
-    uint32_t tupleLength(0);
-    for (const auto &offset : offsets)
-    {
-        n += offset;
-        if (mpz_probab_prime_p(n.get_mpz_t(), iterations) == 0)
-            break;
-        tupleLength++;
+    for (mp_size_t i(0) ; i < size ; i++) { // Zero the lowest Limb at each step, and keep its Carry in it to add all of them at the end
+        const mp_limb_t q(product[i]*minusInverse);
+        product[i] = mpn_addmul_1(&product[i], m, size, q);
+    }
+    const mp_limb_t carry(mpn_add_n(result, &product[size], product, size)); // The result is less than 2m
+    if (carry != 0 || mpn_cmp(result, m, size) >= 0)
+        mpn_sub_n(result, result, m, size);
+}
+
+bool IsFermatProbablePrime(const mpz_class& n)
+{
+    assert(n > 2 && mpz_odd_p(n.get_mpz_t()));
+    const mp_size_t size(mpz_size(n.get_mpz_t()));
+    const mp_limb_t* m(mpz_limbs_read(n.get_mpz_t()));
+    // Newton's Method, the number of correct Bits doubles at each iteration starting from 3 (m*m = 1 mod 8 for odd m)
+    mp_limb_t inverse(m[0]);
+    for (int i(0) ; i < 6 ; i++)
+        inverse *= 2 - m[0]*inverse;
+    // Montgomery Forms of 1 and 2 (R = 2^(size*GMP_NUMB_BITS))
+    mpz_class one, two;
+    mpz_setbit(one.get_mpz_t(), size*GMP_NUMB_BITS);
+    one %= n;
+    two = (one << 1) % n;
+    std::vector<mp_limb_t> oneLimbs(size, 0), x(size, 0), product(2*size);
+    std::copy_n(mpz_limbs_read(one.get_mpz_t()), mpz_size(one.get_mpz_t()), oneLimbs.begin());
+    std::copy_n(mpz_limbs_read(two.get_mpz_t()), mpz_size(two.get_mpz_t()), x.begin());
+    // Left to right Exponentiation, the Base 2 allows to replace the Multiplications by cheap Doublings
+    const mpz_class exponent(n - 1);
+    for (mp_bitcnt_t bit(mpz_sizeinbase(exponent.get_mpz_t(), 2) - 1) ; bit-- > 0 ;) {
+        mpn_sqr(product.data(), x.data(), size);
+        MontgomeryReduce(x.data(), product.data(), m, size, -inverse);
+        if (mpz_tstbit(exponent.get_mpz_t(), bit)) {
+            if (mpn_lshift(x.data(), x.data(), size, 1) != 0 || mpn_cmp(x.data(), m, size) >= 0)
+                mpn_sub_n(x.data(), x.data(), m, size);
+        }
+    }
+    return mpn_cmp(x.data(), oneLimbs.data(), size) == 0;
+}
+
+/** Small Primes used to sieve the Tuple elements, grouped such that their Products fit in a Limb to get all their Remainders with a single Division */
+struct SievePrimeGroup {
+    mp_limb_t product;
+    std::vector<uint32_t> primes;
+};
+
+static const std::vector<SievePrimeGroup>& GetSievePrimeGroups()
+{
+    static const std::vector<SievePrimeGroup> sievePrimeGroups([] {
+        const uint32_t sievePrimes(1024); // Primes up to 8161
+        std::vector<SievePrimeGroup> groups;
+        for (uint32_t i(0) ; i < sievePrimes ; i++) {
+            const mp_limb_t prime(primeTable[i]);
+            if (groups.empty() || groups.back().product > GMP_NUMB_MAX/prime)
+                groups.push_back({1, {}});
+            groups.back().product *= prime;
+            groups.back().primes.push_back(prime);
+        }
+        return groups;
+    }());
+    return sievePrimeGroups;
+}
+
+bool CheckConstellations(const mpz_class& n, const std::vector<std::vector<int32_t>>& patterns, const bool sieveOnly)
+{
+    // Distinct absolute Offsets of all the Tuple elements of all the Patterns, so elements shared by several Patterns are only tested once
+    std::vector<int32_t> offsets;
+    std::vector<std::vector<size_t>> patternsElements;
+    for (const auto& pattern : patterns) {
+        patternsElements.emplace_back();
+        int32_t offset(0);
+        for (const int32_t relativeOffset : pattern) {
+            offset += relativeOffset;
+            const auto offsetIt(std::find(offsets.begin(), offsets.end(), offset));
+            patternsElements.back().push_back(offsetIt - offsets.begin());
+            if (offsetIt == offsets.end())
+                offsets.push_back(offset);
+        }
+    }
+
+    enum class ElementStatus : uint8_t {Unknown, Composite, FermatProbablePrime, ProbablePrime};
+    std::vector<ElementStatus> statuses(offsets.size(), ElementStatus::Unknown);
+    // Stage 1: shared Sieve of all the Tuple elements with Small Primes (only done if n is large enough to not be one of them)
+    if (mpz_sizeinbase(n.get_mpz_t(), 2) > 32) {
+        const mp_limb_t* limbs(mpz_limbs_read(n.get_mpz_t()));
+        const mp_size_t size(mpz_size(n.get_mpz_t()));
+        for (const auto& group : GetSievePrimeGroups()) {
+            const mp_limb_t groupRemainder(mpn_mod_1(limbs, size, group.product));
+            for (const int64_t prime : group.primes) {
+                const int64_t divisibleOffset((prime - static_cast<int64_t>(groupRemainder % prime)) % prime); // n + offset is divisible by the Prime iff offset = divisibleOffset mod Prime
+                for (size_t i(0) ; i < offsets.size() ; i++) {
+                    const int64_t offset(offsets[i]);
+                    if ((offset >= 0 && offset < prime) ? offset == divisibleOffset : (offset % prime + prime) % prime == divisibleOffset)
+                        statuses[i] = ElementStatus::Composite;
+                }
+            }
+        }
     }
-    return tupleLength;
+
+    if (sieveOnly) {
+        return std::any_of(patternsElements.begin(), patternsElements.end(), [&](const std::vector<size_t>& patternElements) {
+            return !patternElements.empty() && std::none_of(patternElements.begin(), patternElements.end(), [&](const size_t i) {return statuses[i] == ElementStatus::Composite;});
+        });
+    }
+
+    for (const auto& patternElements : patternsElements) {
+        if (patternElements.empty())
+            continue;
+        // Stage 2: single Base 2 Fermat Test for each remaining element
+        const auto fermatTest([&](const size_t i) {
+            if (statuses[i] == ElementStatus::Unknown) {
+                const mpz_class element(n + offsets[i]);
+                // Elements with more bits than the largest sieving Prime go through the GMP test instead, whose trial divisions up to their size are much cheaper than a Fermat Test
+                const bool fermatProbablePrime(mpz_sizeinbase(element.get_mpz_t(), 2) > GetSievePrimeGroups().back().primes.back() ?
+                    mpz_probab_prime_p(element.get_mpz_t(), 1) != 0 :
+                    element == 2 || (element > 2 && mpz_odd_p(element.get_mpz_t()) && IsFermatProbablePrime(element)));
+                statuses[i] = fermatProbablePrime ? ElementStatus::FermatProbablePrime : ElementStatus::Composite;
+            }
+            return statuses[i] != ElementStatus::Composite;
+        });
+        if (!std::all_of(patternElements.begin(), patternElements.end(), fermatTest))
+            continue;
+        // Stage 3: full Primality Tests, only if the Pattern passed the cheap Tests for all its elements
+        const auto primalityTest([&](const size_t i) {
+            if (statuses[i] == ElementStatus::FermatProbablePrime)
+                statuses[i] = mpz_probab_prime_p(mpz_class(n + offsets[i]).get_mpz_t(), 31) != 0 ? ElementStatus::ProbablePrime : ElementStatus::Composite;
+            return statuses[i] == ElementStatus::ProbablePrime;
+        });
+        if (std::all_of(patternElements.begin(), patternElements.end(), primalityTest))
+            return true;
+    }
+    return false;
 }
 
 static std::vector<uint64_t> GeneratePrimeTable(const uint64_t limit) // Using Sieve of Eratosthenes
@@ -218,14 +355,34 @@ static std::vector<uint64_t> GeneratePrimeTable(const uint64_t limit) // Using S
 }
 const std::vector<uint64_t> primeTable(GeneratePrimeTable(821641)); // Used to calculate the Primorial when checking
 
-// Bypasses the actual proof of work check during fuzz testing .
-bool CheckProofOfWork(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params)
+static constexpr uint16_t MAX_CACHED_PRIMORIAL_NUMBER{1024};
+static Mutex g_primorials_mutex;
+static std::vector<mpz_class> g_primorials GUARDED_BY(g_primorials_mutex){1}; // Primorials of the first i Primes, grown on demand
+
+std::optional<mpz_class> GetPrimorial(const uint16_t primorialNumber, const std::optional<mpz_class>& limit)
 {
-    if (EnableFuzzDeterminism()) return true;
-    return CheckProofOfWorkImpl(hash, nBits, nOnce, params);
+    mpz_class primorial;
+    uint16_t i;
+    {
+        LOCK(g_primorials_mutex);
+        const size_t cachedNumber(std::min(primorialNumber, MAX_CACHED_PRIMORIAL_NUMBER));
+        while (g_primorials.size() <= cachedNumber && !(limit && g_primorials.back() > *limit))
+            g_primorials.push_back(g_primorials.back()*primeTable[g_primorials.size() - 1]);
+        i = std::min(cachedNumber, g_primorials.size() - 1);
+        primorial = g_primorials[i];
+    }
+    for ( ; i < primorialNumber ; i++) { // Beyond the cached Primorials, or if the limit was reached
+        if (limit && primorial > *limit)
+            return std::nullopt;
+        mpz_mul_ui(primorial.get_mpz_t(), primorial.get_mpz_t(), primeTable[i]);
+    }
+    if (limit && primorial > *limit)
+        return std::nullopt;
+    return primorial;
 }
 
-bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params)
+//! The structural checks always run, then either only the Small Primes Sieve or all the Constellation Tests
+static bool CheckProofOfWorkStages(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params, const bool sieveOnly)
 {
     uint64_t nBitsOffset(0ULL);
     if (hash == params.hashGenesisBlockForPoW)
@@ -268,18 +425,15 @@ bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, uint256 nOnce, const
     {
         const uint8_t* rawOffset(nOnce.begin()); // [31-30 Primorial Number|29-14 Primorial Factor|13-2 Primorial Offset|1-0 Reserved/Version]
         const uint16_t primorialNumber(reinterpret_cast<const uint16_t*>(&rawOffset[30])[0]);
-        mpz_class primorial(1), primorialFactor, primorialOffset;
-        for (uint16_t i(0) ; i < primorialNumber ; i++)
-        {
-            mpz_mul_ui(primorial.get_mpz_t(), primorial.get_mpz_t(), primeTable[i]);
-            if (primorial > offsetLimit) {
-                LogError("CheckProofOfWork(): too large Primorial Number %s\n", primorialNumber);
-                return false;
-            }
+        const std::optional<mpz_class> primorial(GetPrimorial(primorialNumber, offsetLimit));
+        if (!primorial) {
+            LogError("CheckProofOfWork(): too large Primorial Number %s\n", primorialNumber);
+            return false;
         }
+        mpz_class primorialFactor, primorialOffset;
         mpz_import(primorialFactor.get_mpz_t(), 16, -1, sizeof(uint8_t), 0, 0, &rawOffset[14]);
         mpz_import(primorialOffset.get_mpz_t(), 12, -1, sizeof(uint8_t), 0, 0, &rawOffset[2]);
-        offset = primorial - (*target % primorial) + primorialFactor*primorial + primorialOffset;
+        offset = *primorial - (*target % *primorial) + primorialFactor*(*primorial) + primorialOffset;
     }
     if (offset >= offsetLimit) {
         LogError("CheckProofOfWork(): offset %s larger than allowed 2^%d\n", offset.get_str().c_str(), *trailingZeros);
@@ -288,20 +442,59 @@ bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, uint256 nOnce, const
     const mpz_class result(*target + offset);
 
     // Check PoW result
-    std::vector<uint32_t> tupleLengths;
-    std::vector<std::vector<int32_t>> acceptedPatterns;
-    if (powVersion == -1)
-        acceptedPatterns = {{0, 4, 2, 4, 2, 4}};
-    else if (powVersion == 1)
-        acceptedPatterns = params.powAcceptedPatterns;
-    for (const auto &pattern : acceptedPatterns)
-    {
-        tupleLengths.push_back(CheckConstellation(result, pattern, 1)); // Quick single iteration test first
-        if (tupleLengths.back() != pattern.size())
-            continue;
-        tupleLengths.back() = CheckConstellation(result, pattern, 31);
-        if (tupleLengths.back() == pattern.size())
-            return true;
-    }
-    return false;
+    static const std::vector<std::vector<int32_t>> legacyPatterns{{0, 4, 2, 4, 2, 4}};
+    return CheckConstellations(result, powVersion == -1 ? legacyPatterns : params.powAcceptedPatterns, sieveOnly);
+}
+
+static thread_local std::atomic<int64_t>* g_pow_cost{nullptr};
+
+PoWCostScope::PoWCostScope(std::atomic<int64_t>* cost) : m_previous(g_pow_cost)
+{
+    g_pow_cost = cost;
+}
+
+PoWCostScope::~PoWCostScope()
+{
+    g_pow_cost = m_previous;
+}
+
+std::atomic<int64_t>* PoWCostScope::Current()
+{
+    return g_pow_cost;
+}
+
+void PoWCostScope::Account(std::chrono::microseconds time)
+{
+    if (g_pow_cost)
+        g_pow_cost->fetch_add(count_microseconds(time), std::memory_order_relaxed);
+}
+
+template <typename Check>
+static bool AccountPoWCost(const Check& check)
+{
+    std::atomic<int64_t>* const cost(g_pow_cost);
+    if (!cost)
+        return check();
+    const auto start(SteadyClock::now());
+    const bool result(check());
+    cost->fetch_add(Ticks<std::chrono::microseconds>(SteadyClock::now() - start), std::memory_order_relaxed);
+    return result;
+}
+
+// Bypasses the actual proof of work check during fuzz testing .
+bool CheckProofOfWork(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params)
+{
+    if (EnableFuzzDeterminism()) return true;
+    return AccountPoWCost([&] {return CheckProofOfWorkImpl(hash, nBits, nOnce, params);});
+}
+
+bool PreScreenProofOfWork(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params)
+{
+    if (EnableFuzzDeterminism()) return true;
+    return AccountPoWCost([&] {return CheckProofOfWorkStages(hash, nBits, nOnce, params, /*sieveOnly=*/true);});
+}
+
+bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, uint256 nOnce, const Consensus::Params& params)
+{
+    return CheckProofOfWorkStages(hash, nBits, nOnce, params, /*sieveOnly=*/false);
 }
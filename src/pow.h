@@ -11,13 +11,19 @@
 #include <gmp.h>
 #include <gmpxx.h>
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <optional>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
 class uint256;
 class arith_uint256;
 
+/** Number of bits of the Target after its significative digits, which is also the size in bits of the allowed Offsets, or nullopt if nBits or powVersion is invalid */
+std::optional<uint32_t> DeriveTrailingZeros(unsigned int nBits, unsigned int nBitsOffset, int32_t powVersion, uint32_t nBitsMin);
 /**
  * Convert nBits value to target.
  *
@@ -40,8 +46,54 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const Consensus:
 unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&);
 
 extern const std::vector<uint64_t> primeTable;
+/**
+ * Get the Primorial of the first primorialNumber Primes of primeTable.
+ * The Primorials are cached as Miners almost always use the same Primorial Numbers.
+ *
+ * @param[in] primorialNumber number of Primes to multiply
+ * @param[in] limit           if set, maximum value of the Primorial
+ *
+ * @return                    the Primorial or nullopt if it is larger than limit
+ */
+std::optional<mpz_class> GetPrimorial(uint16_t primorialNumber, const std::optional<mpz_class>& limit = std::nullopt);
+/** Base 2 Fermat Test using Montgomery Multiplication, n must be odd and larger than 2 */
+bool IsFermatProbablePrime(const mpz_class& n);
+/**
+ * Check whether n is the first number of a Prime Constellation following one of the given Patterns (offsets relative to the previous Tuple element).
+ * The elements of all the Patterns are first sieved together with small Primes, then a single Base 2 Fermat Test is done for each remaining element,
+ * and only the Patterns whose elements all passed these are checked with the full Primality Tests.
+ * If sieveOnly, only the Sieve is done, and true means that one of the Patterns may be present.
+ */
+bool CheckConstellations(const mpz_class& n, const std::vector<std::vector<int32_t>>& patterns, bool sieveOnly = false);
 /** Check whether a Nonce satisfies the proof-of-work requirement */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, uint256 nNonce, const Consensus::Params&);
 bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, uint256 nNonce, const Consensus::Params&);
+/**
+ * Cheap first stage of CheckProofOfWork: structural nNonce and nBits checks, Offset limit and Small Primes Sieve of all the Tuple elements.
+ * False means that the PoW is invalid, true that only the expensive Primality Tests of CheckProofOfWork can tell.
+ * The cost still grows with nBits, so implausible ones must be filtered before.
+ */
+bool PreScreenProofOfWork(uint256 hash, unsigned int nBits, uint256 nNonce, const Consensus::Params&);
+
+/**
+ * While alive, the time spent by CheckProofOfWork and PreScreenProofOfWork on the thread is added to the given counter (in microseconds),
+ * for example to account the cost of the Headers and Blocks of a peer. Scopes can be nested, the innermost one getting the time.
+ */
+class PoWCostScope
+{
+public:
+    explicit PoWCostScope(std::atomic<int64_t>* cost);
+    ~PoWCostScope();
+    PoWCostScope(const PoWCostScope&) = delete;
+    PoWCostScope& operator=(const PoWCostScope&) = delete;
+
+    //! Counter of the innermost scope of the thread
+    static std::atomic<int64_t>* Current();
+    //! Add the time to the counter of the innermost scope of the thread, if any, like for work handed to other threads
+    static void Account(std::chrono::microseconds time);
+
+private:
+    std::atomic<int64_t>* m_previous;
+};
 
 #endif // BITCOIN_POW_H
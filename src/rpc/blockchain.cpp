@@ -1422,9 +1422,8 @@ static RPCMethod getresult()
         target = *DeriveTarget(block.GetHashForPoW(), block.nBits, nBitsOffset, powVersion, chainman.GetConsensus().nBitsMin);
         const uint8_t* rawOffset(nNonce.begin()); // [31-30 Primorial Number|29-14 Primorial Factor|13-2 Primorial Offset|1-0 Difficulty Offset/Version]
         const uint16_t primorialNumber(reinterpret_cast<const uint16_t*>(&rawOffset[30])[0]);
-        mpz_class primorial(1), primorialFactor, primorialOffset;
-        for (uint16_t i(0) ; i < primorialNumber ; i++)
-            mpz_mul_ui(primorial.get_mpz_t(), primorial.get_mpz_t(), primeTable[i]);
+        const mpz_class primorial(*GetPrimorial(primorialNumber));
+        mpz_class primorialFactor, primorialOffset;
         mpz_import(primorialFactor.get_mpz_t(), 16, -1, sizeof(uint8_t), 0, 0, &rawOffset[14]);
         mpz_import(primorialOffset.get_mpz_t(), 12, -1, sizeof(uint8_t), 0, 0, &rawOffset[2]);
         offset = primorial - (target % primorial) + primorialFactor*primorial + primorialOffset;
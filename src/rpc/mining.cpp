@@ -13,6 +13,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <chainparamsbase.h>
+#include <common/args.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
@@ -28,6 +29,7 @@
 #include <node/context.h>
 #include <node/miner.h>
 #include <node/mining_args.h>
+#include <node/mining_power.h>
 #include <node/mining_types.h>
 #include <node/warnings.h>
 #include <policy/feerate.h>
@@ -94,44 +96,13 @@ using util::ToString;
  * It is assumed to be proportional to Difficulty^(Constellation Length + 2.3), corresponding to observations using the current miner implementation.
  * The metric may be improved at any time.
  */
-static UniValue GetNetworkMiningPower(int lookup, int height, const CChain& active_chain) {
+static UniValue GetNetworkMiningPower(int lookup, int height, const ChainstateManager& chainman, node::MiningPowerEstimator& estimator) {
     if (lookup <= 0)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid nblocks. Must be greater than 0.");
-    if (height < -1 || height > active_chain.Height())
+    const CBlockIndex* tip(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()));
+    if (tip == nullptr || height < -1 || height > tip->nHeight)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Block does not exist at specified height");
-    const CBlockIndex* pb = active_chain.Tip();
-
-    if (height >= 0)
-        pb = active_chain[height];
-
-    if (pb == nullptr || !pb->nHeight)
-        return 0;
-
-    // If lookup is larger than chain, then set it to chain length.
-    if (lookup > pb->nHeight)
-        lookup = pb->nHeight;
-
-    const CBlockIndex* pb0 = pb;
-    int64_t minTime = pb0->GetBlockTime();
-    int64_t maxTime = minTime;
-    const Consensus::Params& consensusParams(Params().GetConsensus());
-    double miningPower(0.), expectedDuration(consensusParams.nPowTargetSpacing*lookup);
-    for (int i = 0; i < lookup; i++) {
-        double difficulty(GetDifficulty(*pb0)),
-               referenceDifficulty(static_cast<double>((consensusParams.nBitsMin)/256.)),
-               constellationSize(consensusParams.GetPowAcceptedPatternsAtHeight(pb0->nHeight)[0].size());
-        miningPower += std::pow(difficulty/referenceDifficulty, constellationSize + 2.3);
-        pb0 = pb0->pprev;
-        int64_t time = pb0->GetBlockTime();
-        minTime = std::min(time, minTime);
-        maxTime = std::max(time, maxTime);
-    }
-
-    // In case there's a situation where minTime == maxTime, we don't want a divide by zero exception.
-    if (minTime == maxTime)
-        return 0;
-
-    return (expectedDuration/(maxTime - minTime))*(miningPower/lookup);
+    return estimator.Estimate(*tip, height, lookup);
 }
 
 static RPCMethod getnetworkminingpower()
@@ -153,24 +124,18 @@ static RPCMethod getnetworkminingpower()
                 },
         [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
 {
-    ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    return GetNetworkMiningPower(self.Arg<int>("nblocks"), self.Arg<int>("height"), chainman.ActiveChain());
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    return GetNetworkMiningPower(self.Arg<int>("nblocks"), self.Arg<int>("height"), EnsureChainman(node), EnsureMiningPowerEstimator(node));
 },
     };
 }
 
-static bool GenerateBlock(ChainstateManager& chainman, CBlock&& block, uint64_t& max_tries, std::shared_ptr<const CBlock>& block_out, bool process_new_block)
+static bool GenerateBlock(ChainstateManager& chainman, CBlock&& block, uint64_t& max_tries, int threads, std::shared_ptr<const CBlock>& block_out, bool process_new_block)
 {
     block_out.reset();
     block.hashMerkleRoot = BlockMerkleRoot(block);
 
-    block.nNonce = UintToArith256(uint256{"0000000000000000000000000000000000000000000000000000000000000002"}); // PoW Version 1 (0002), Primorial Number 1 (Primorial = 2), Parameters at 0. Note that due to the Primorial then being 1 here, +1 is added to the Primorial Offsets for the Target Offsets.
-    while (max_tries > 0 && block.nNonce < std::numeric_limits<uint32_t>::max() && !CheckProofOfWork(block.GetHashForPoW(), block.nBits, ArithToUint256(block.nNonce), chainman.GetConsensus()) && !chainman.m_interrupt) {
-        block.nNonce += 131072; // Brute Force Prime Number Search (increment by 2 until we find one)
-        --max_tries;
-    }
-    if (max_tries == 0 || chainman.m_interrupt) {
+    if (!node::MineProofOfWork(block, chainman.GetConsensus(), max_tries, threads, chainman.m_interrupt)) {
         return false;
     }
 
@@ -185,7 +150,7 @@ static bool GenerateBlock(ChainstateManager& chainman, CBlock&& block, uint64_t&
     return true;
 }
 
-static UniValue generateBlocks(ChainstateManager& chainman, Mining& miner, const CScript& coinbase_output_script, int nGenerate, uint64_t nMaxTries)
+static UniValue generateBlocks(ChainstateManager& chainman, Mining& miner, const CScript& coinbase_output_script, int nGenerate, uint64_t nMaxTries, int threads)
 {
     UniValue blockHashes(UniValue::VARR);
     while (nGenerate > 0 && !chainman.m_interrupt) {
@@ -193,7 +158,7 @@ static UniValue generateBlocks(ChainstateManager& chainman, Mining& miner, const
         CHECK_NONFATAL(block_template);
 
         std::shared_ptr<const CBlock> block_out;
-        if (!GenerateBlock(chainman, block_template->getBlock(), nMaxTries, block_out, /*process_new_block=*/true)) {
+        if (!GenerateBlock(chainman, block_template->getBlock(), nMaxTries, threads, block_out, /*process_new_block=*/true)) {
             break;
         }
 
@@ -273,7 +238,7 @@ static RPCMethod generatetodescriptor()
     Mining& miner = EnsureMining(node);
     ChainstateManager& chainman = EnsureChainman(node);
 
-    return generateBlocks(chainman, miner, coinbase_output_script, num_blocks, max_tries);
+    return generateBlocks(chainman, miner, coinbase_output_script, num_blocks, max_tries, node::ReadGenerateThreads(EnsureArgsman(node)));
 },
     };
 }
@@ -321,7 +286,7 @@ static RPCMethod generatetoaddress()
 
     CScript coinbase_output_script = GetScriptForDestination(destination);
 
-    return generateBlocks(chainman, miner, coinbase_output_script, num_blocks, max_tries);
+    return generateBlocks(chainman, miner, coinbase_output_script, num_blocks, max_tries, node::ReadGenerateThreads(EnsureArgsman(node)));
 },
     };
 }
@@ -421,7 +386,7 @@ static RPCMethod generateblock()
     std::shared_ptr<const CBlock> block_out;
     uint64_t max_tries{DEFAULT_MAX_TRIES};
 
-    if (!GenerateBlock(chainman, std::move(block), max_tries, block_out, process_new_block) || !block_out) {
+    if (!GenerateBlock(chainman, std::move(block), max_tries, node::ReadGenerateThreads(EnsureArgsman(node)), block_out, process_new_block) || !block_out) {
         throw JSONRPCError(RPC_MISC_ERROR, "Failed to make block.");
     }
 
@@ -475,6 +440,8 @@ static RPCMethod getmininginfo()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     const CTxMemPool& mempool = EnsureMemPool(node);
     ChainstateManager& chainman = EnsureChainman(node);
+    // Estimated before taking cs_main, as the first estimate walks the whole chain
+    const UniValue network_mining_power{getnetworkminingpower().HandleRequest(request)};
     LOCK(cs_main);
     const CChain& active_chain = chainman.ActiveChain();
     CBlockIndex& tip{*CHECK_NONFATAL(active_chain.Tip())};
@@ -485,7 +452,7 @@ static RPCMethod getmininginfo()
     if (BlockAssembler::m_last_block_num_txs) obj.pushKV("currentblocktx", *BlockAssembler::m_last_block_num_txs);
     obj.pushKV("bits", strprintf("%08x", tip.nBits));
     obj.pushKV("difficulty", GetDifficulty(tip));
-    obj.pushKV("networkminingpower", getnetworkminingpower().HandleRequest(request));
+    obj.pushKV("networkminingpower", network_mining_power);
     obj.pushKV("pooledtx", mempool.size());
     const auto mining_options{node::FlattenMiningOptions(node.mining_args)};
     obj.pushKV("blockmintxfee", ValueFromAmount(CHECK_NONFATAL(mining_options.block_min_fee_rate)->GetFeePerK()));
@@ -182,6 +182,7 @@ static RPCMethod getpeerinfo()
                         {RPCResult::Type::STR, "permission_type", Join(NET_PERMISSIONS_DOC, ",\n") + ".\n"},
                     }},
                     {RPCResult::Type::NUM, "minfeefilter", "The minimum fee rate for transactions this peer accepts"},
+                    {RPCResult::Type::NUM, "pow_check_time", "The total wall-clock time in seconds spent checking the proof of work of the headers and blocks received from this peer. Header batches verified by several threads count for their wall-clock time"},
                     {RPCResult::Type::OBJ_DYN, "bytessent_per_msg", "",
                     {
                         {RPCResult::Type::NUM, "msg", "The total bytes sent aggregated by message type\n"
@@ -289,6 +290,7 @@ static RPCMethod getpeerinfo()
         }
         obj.pushKV("permissions", std::move(permissions));
         obj.pushKV("minfeefilter", ValueFromAmount(statestats.m_fee_filter_received));
+        obj.pushKV("pow_check_time", Ticks<SecondsDouble>(statestats.m_pow_check_time));
 
         UniValue sendPerMsgType(UniValue::VOBJ);
         for (const auto& i : stats.mapSendBytesPerMsgType) {
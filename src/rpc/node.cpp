@@ -7,6 +7,7 @@
 #include <riecoin-build-config.h> // IWYU pragma: keep
 
 #include <chainparams.h>
+#include <dbwrapper.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
@@ -18,16 +19,19 @@
 #include <interfaces/ipc.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <scheduler.h>
 #include <tinyformat.h>
+#include <txdb.h>
 #include <univalue.h>
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validation.h>
 
 #include <cstdint>
 #ifdef HAVE_MALLOC_INFO
@@ -412,12 +416,111 @@ static RPCMethod getindexinfo()
     };
 }
 
+static UniValue DBStatsToJSON(const DBStats& stats)
+{
+    UniValue levels(UniValue::VARR);
+    for (const DBStats::Level& level : stats.levels) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("files", uint64_t(level.files));
+        entry.pushKV("size", level.bytes);
+        entry.pushKV("compaction_time", level.compaction_seconds);
+        entry.pushKV("compaction_read", level.compaction_read_bytes);
+        entry.pushKV("compaction_written", level.compaction_written_bytes);
+        levels.push_back(std::move(entry));
+    }
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("memory_usage", uint64_t(stats.memory_usage));
+    ret.pushKV("levels", std::move(levels));
+    ret.pushKV("lookups", stats.lookups);
+    ret.pushKV("lookup_file_reads", stats.lookup_file_reads);
+    ret.pushKV("read_amplification", stats.lookups ? double(stats.lookup_file_reads) / stats.lookups : 0.0);
+    if (stats.bloom_checks && stats.bloom_rejections) {
+        ret.pushKV("bloom_checks", *stats.bloom_checks);
+        ret.pushKV("bloom_rejection_rate", *stats.bloom_checks ? double(*stats.bloom_rejections) / *stats.bloom_checks : 0.0);
+    }
+    ret.pushKV("write_slowdowns", stats.write_slowdowns);
+    ret.pushKV("write_stalls", stats.write_stalls);
+    return ret;
+}
+
+static RPCMethod getdbstats()
+{
+    return RPCMethod{
+        "getdbstats",
+        "Returns the statistics of the chainstate, block index and index databases since they were opened, for tuning them with the -db* options.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "", {
+                        {
+                            RPCResult::Type::OBJ, "name", "The name of the database: chainstate, blockindex, or the name of the index", {
+                                {RPCResult::Type::NUM, "memory_usage", "Memory used by the caches and write buffers, in bytes"},
+                                {RPCResult::Type::ARR, "levels", "The levels of the database from the newest data to the oldest, or a single one for LogDB", {
+                                    {RPCResult::Type::OBJ, "", "", {
+                                        {RPCResult::Type::NUM, "files", "Number of files"},
+                                        {RPCResult::Type::NUM, "size", "Size of the files, in bytes"},
+                                        {RPCResult::Type::NUM, "compaction_time", "Time spent compacting into the level, in seconds (in whole seconds for LevelDB)"},
+                                        {RPCResult::Type::NUM, "compaction_read", "Bytes read by these compactions (in whole MiB for LevelDB)"},
+                                        {RPCResult::Type::NUM, "compaction_written", "Bytes written by these compactions (in whole MiB for LevelDB)"},
+                                    }},
+                                }},
+                                {RPCResult::Type::NUM, "lookups", "Number of point lookups"},
+                                {RPCResult::Type::NUM, "lookup_file_reads", "Number of file blocks read by the lookups, which were not cached"},
+                                {RPCResult::Type::NUM, "read_amplification", "File blocks read per lookup"},
+                                {RPCResult::Type::NUM, "bloom_checks", /*optional=*/true, "Number of bloom filter probes, if the database has bloom filters"},
+                                {RPCResult::Type::NUM, "bloom_rejection_rate", /*optional=*/true, "Fraction of the bloom filter probes which ruled out the key, saving a file read"},
+                                {RPCResult::Type::NUM, "write_slowdowns", "Number of writes delayed by 1ms as compactions fell behind"},
+                                {RPCResult::Type::NUM, "write_stalls", "Number of times the writes waited for a compaction"},
+                            }
+                        },
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("getdbstats", "")
+                  + HelpExampleRpc("getdbstats", "")
+                },
+                [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman{EnsureAnyChainman(request.context)};
+    // The statistics are read without cs_main, nor waiting for a coins flush written in the background
+    CCoinsViewDB* coins_db;
+    kernel::BlockTreeDB* block_tree_db;
+    {
+        LOCK(cs_main);
+        coins_db = &chainman.ActiveChainstate().CoinsDBUnflushed();
+        block_tree_db = chainman.m_blockman.m_block_tree_db.get();
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("chainstate", DBStatsToJSON(coins_db->GetDBStats()));
+    result.pushKV("blockindex", DBStatsToJSON(block_tree_db->GetStats()));
+
+    if (g_txindex) {
+        result.pushKV(g_txindex->GetName(), DBStatsToJSON(g_txindex->GetDBStats()));
+    }
+
+    if (g_coin_stats_index) {
+        result.pushKV(g_coin_stats_index->GetName(), DBStatsToJSON(g_coin_stats_index->GetDBStats()));
+    }
+
+    if (g_txospenderindex) {
+        result.pushKV(g_txospenderindex->GetName(), DBStatsToJSON(g_txospenderindex->GetDBStats()));
+    }
+
+    ForEachBlockFilterIndex([&result](const BlockFilterIndex& index) {
+        result.pushKV(index.GetName(), DBStatsToJSON(index.GetDBStats()));
+    });
+
+    return result;
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
         {"util", &getindexinfo},
+        {"util", &getdbstats},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
         {"hidden", &echo},
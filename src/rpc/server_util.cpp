@@ -9,6 +9,7 @@
 #include <net_processing.h>
 #include <node/context.h>
 #include <node/miner.h>
+#include <node/mining_power.h>
 #include <policy/fees/block_policy_estimator.h>
 #include <pow.h>
 #include <rpc/protocol.h>
@@ -19,6 +20,7 @@
 
 #include <any>
 
+using node::MiningPowerEstimator;
 using node::NodeContext;
 using node::UpdateTime;
 
@@ -97,6 +99,14 @@ CBlockPolicyEstimator& EnsureAnyFeeEstimator(const std::any& context)
     return EnsureFeeEstimator(EnsureAnyNodeContext(context));
 }
 
+MiningPowerEstimator& EnsureMiningPowerEstimator(const NodeContext& node)
+{
+    if (!node.mining_power_estimator) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Mining power estimation disabled");
+    }
+    return *node.mining_power_estimator;
+}
+
 CConnman& EnsureConnman(const NodeContext& node)
 {
     if (!node.connman) {
@@ -19,6 +19,7 @@ class ChainstateManager;
 class PeerManager;
 class BanMan;
 namespace node {
+class MiningPowerEstimator;
 struct NodeContext;
 } // namespace node
 namespace interfaces {
@@ -37,6 +38,7 @@ ChainstateManager& EnsureAnyChainman(const std::any& context);
 CBlockPolicyEstimator& EnsureFeeEstimator(const node::NodeContext& node);
 CBlockPolicyEstimator& EnsureAnyFeeEstimator(const std::any& context);
 CConnman& EnsureConnman(const node::NodeContext& node);
+node::MiningPowerEstimator& EnsureMiningPowerEstimator(const node::NodeContext& node);
 interfaces::Mining& EnsureMining(const node::NodeContext& node);
 PeerManager& EnsurePeerman(const node::NodeContext& node);
 AddrMan& EnsureAddrman(const node::NodeContext& node);
@@ -6,12 +6,14 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -19,9 +21,14 @@
 #include <test/util/logging.h>
 #include <test/util/setup_common.h>
 
+#include <deque>
+#include <map>
+
 using kernel::CBlockFileInfo;
+using node::BLOCKFILE_CHUNK_SIZE;
 using node::STORAGE_HEADER_BYTES;
 using node::BlockManager;
+using node::BlockTreeDB;
 using node::KernelNotifications;
 using node::MAX_BLOCKFILE_SIZE;
 
@@ -232,6 +239,77 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
     BOOST_CHECK(!m_node.chainman->m_blockman.ReadBlock(block, index));
 }
 
+BOOST_AUTO_TEST_CASE(blocktreedb_load_inconsistent_entry)
+{
+    BlockTreeDB block_tree_db{DBParams{
+        .path = m_args.GetDataDirNet() / "blocks" / "index",
+        .cache_bytes = 1 << 20,
+        .memory_only = true,
+    }};
+    const CBlock& genesis{Params().GenesisBlock()};
+    const uint256 hash{genesis.GetHash()};
+    CBlockIndex index{genesis};
+    index.phashBlock = &hash;
+    block_tree_db.WriteBatchSync({}, 0, {&index});
+
+    std::map<uint256, CBlockIndex> loaded;
+    const auto insert_block_index{[&loaded](const uint256& hash) { return hash.IsNull() ? nullptr : &loaded.try_emplace(hash).first->second; }};
+    BOOST_CHECK(WITH_LOCK(::cs_main, return block_tree_db.LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, *Assert(m_node.shutdown_signal))));
+    BOOST_CHECK_EQUAL(loaded.at(hash).nNonce, genesis.nNonce);
+
+    // Corrupt the PoW data of the entry, which must be detected on load without running the PoW Check
+    index.nNonce += 131072;
+    block_tree_db.WriteBatchSync({}, 0, {&index});
+    loaded.clear();
+    ASSERT_DEBUG_LOG("is inconsistent with its header");
+    BOOST_CHECK(!WITH_LOCK(::cs_main, return block_tree_db.LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, *Assert(m_node.shutdown_signal))));
+}
+
+BOOST_AUTO_TEST_CASE(blocktreedb_load_parallel)
+{
+    BlockTreeDB block_tree_db{DBParams{
+        .path = m_args.GetDataDirNet() / "blocks" / "index",
+        .cache_bytes = 1 << 20,
+        .memory_only = true,
+    }};
+    // Enough entries for every range of hashes, chained like a block index
+    CBlockHeader header{Params().GenesisBlock()};
+    std::vector<uint256> hashes;
+    std::deque<CBlockIndex> indexes;
+    for (int height{0}; height < 3000; height++) {
+        header.hashPrevBlock = height == 0 ? uint256{} : hashes.back();
+        header.nTime++;
+        hashes.push_back(header.GetHash());
+        indexes.emplace_back(header).nHeight = height;
+    }
+    std::vector<const CBlockIndex*> to_write;
+    for (size_t i{0}; i < indexes.size(); i++) {
+        indexes[i].phashBlock = &hashes[i];
+        indexes[i].pprev = i == 0 ? nullptr : &indexes[i - 1];
+        to_write.push_back(&indexes[i]);
+    }
+    block_tree_db.WriteBatchSync({}, 0, to_write);
+
+    const auto load{[&](ThreadPool* pool) {
+        std::map<uint256, CBlockIndex> loaded;
+        const auto insert_block_index{[&loaded](const uint256& hash) { return hash.IsNull() ? nullptr : &loaded.try_emplace(hash).first->second; }};
+        BOOST_CHECK(WITH_LOCK(::cs_main, return block_tree_db.LoadBlockIndexGuts(Params().GetConsensus(), insert_block_index, *Assert(m_node.shutdown_signal), pool)));
+        return loaded;
+    }};
+    ThreadPool pool{"blkidxtest"};
+    pool.Start(3);
+    const auto sequential{load(nullptr)}, parallel{load(&pool)};
+    BOOST_REQUIRE_EQUAL(sequential.size(), indexes.size());
+    BOOST_REQUIRE_EQUAL(parallel.size(), indexes.size());
+    for (size_t i{0}; i < indexes.size(); i++) {
+        const CBlockIndex& index{parallel.at(hashes[i])};
+        BOOST_CHECK_EQUAL(index.nHeight, sequential.at(hashes[i]).nHeight);
+        BOOST_CHECK_EQUAL(index.nHeight, static_cast<int>(i));
+        BOOST_CHECK(index.nNonce == indexes[i].nNonce);
+        BOOST_CHECK_EQUAL(index.pprev ? index.pprev->nHeight + 1 : 0, index.nHeight);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
 {
     KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
@@ -274,15 +352,13 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     CBlock read_block;
     BOOST_CHECK_EQUAL(read_block.nVersion, 0);
     {
-        //ASSERT_DEBUG_LOG("Errors in block header");
-        //BOOST_CHECK(!blockman.ReadBlock(read_block, pos1, {}));
-        blockman.ReadBlock(read_block, pos1, {});
+        ASSERT_DEBUG_LOG("Errors in block header");
+        BOOST_CHECK(!blockman.ReadBlock(read_block, pos1, {}));
         BOOST_CHECK_EQUAL(read_block.nVersion, 1);
     }
     {
-        //ASSERT_DEBUG_LOG("Errors in block header");
-        //BOOST_CHECK(!blockman.ReadBlock(read_block, pos2, {}));
-        blockman.ReadBlock(read_block, pos2, {});
+        ASSERT_DEBUG_LOG("Errors in block header");
+        BOOST_CHECK(!blockman.ReadBlock(read_block, pos2, {}));
         BOOST_CHECK_EQUAL(read_block.nVersion, 2);
     }
 
@@ -304,6 +380,110 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_read_mapped_block_file)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    for (const bool use_xor : {false, true}) {
+        const fs::path blocks_dir{m_args.GetDataDirNet() / fs::u8path(strprintf("blocks_xor%d", use_xor))};
+        fs::create_directories(blocks_dir);
+        const auto make_blockman{[&](bool use_mmap, const char* index_name) {
+            return std::make_unique<BlockManager>(*Assert(m_node.shutdown_signal), BlockManager::Options{
+                .chainparams = Params(),
+                .use_xor = use_xor,
+                .use_mmap = use_mmap,
+                .blocks_dir = blocks_dir,
+                .notifications = notifications,
+                .block_tree_db_params = DBParams{
+                    .path = blocks_dir / index_name,
+                    .cache_bytes = 0,
+                    .memory_only = true,
+                },
+            });
+        }};
+        const auto writer{make_blockman(/*use_mmap=*/false, "index")};
+        const auto reader{make_blockman(/*use_mmap=*/true, "index_mmap")};
+
+        std::vector<std::pair<uint256, FlatFilePos>> written;
+        const auto write_blocks{[&](int count) {
+            for (int i{0}; i < count; i++) {
+                CBlock block{Params().GenesisBlock()};
+                block.nVersion = written.size();
+                written.emplace_back(block.GetHash(), writer->WriteBlock(block, written.size()));
+            }
+        }};
+        const auto check_blocks{[&] {
+            for (const auto& [hash, pos] : written) {
+                CBlock block;
+                BOOST_CHECK(reader->ReadBlock(block, pos, hash));
+                const auto raw{writer->ReadRawBlock(pos)};
+                const auto raw_mapped{reader->ReadRawBlock(pos)};
+                BOOST_REQUIRE(raw && raw_mapped);
+                BOOST_CHECK(*raw == *raw_mapped);
+                const auto part{reader->ReadRawBlock(pos, std::pair{size_t{10}, size_t{100}})};
+                BOOST_REQUIRE(part);
+                BOOST_CHECK(std::ranges::equal(*part, std::span{*raw}.subspan(10, 100)));
+                const auto bad_part{reader->ReadRawBlock(pos, std::pair{size_t{1}, raw->size()})};
+                BOOST_CHECK(!bad_part && bad_part.error() == node::ReadRawError::BadPartRange);
+            }
+        }};
+        // Blocks written after the block file was mapped are read too
+        write_blocks(10);
+        check_blocks();
+        write_blocks(10);
+        check_blocks();
+        // So is a block starting in the mapping and ending in a chunk of the block file allocated since
+        {
+            CBlock block{Params().GenesisBlock()};
+            CMutableTransaction tx{*block.vtx[0]};
+            tx.vout[0].scriptPubKey.assign(BLOCKFILE_CHUNK_SIZE, OP_TRUE);
+            block.vtx[0] = MakeTransactionRef(std::move(tx));
+            block.nVersion = written.size();
+            written.emplace_back(block.GetHash(), writer->WriteBlock(block, written.size()));
+            BOOST_CHECK_LT(written.back().second.nPos, BLOCKFILE_CHUNK_SIZE);
+        }
+        write_blocks(1);
+        check_blocks();
+        {
+            ASSERT_DEBUG_LOG("Block magic mismatch");
+            CBlock block;
+            BOOST_CHECK(!reader->ReadBlock(block, FlatFilePos{0, written[1].second.nPos + 1}, std::nullopt));
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockprefetcher_read_ahead, TestChain100Setup)
+{
+    // The background reads must not need cs_main, which the consumer may hold
+    LOCK(cs_main);
+    auto& blockman{m_node.chainman->m_blockman};
+    const CChain& chain{m_node.chainman->ActiveChain()};
+    const auto next{[&](const CBlockIndex& block) { return chain.Next(block); }};
+    const auto check_read{[&](node::BlockPrefetcher& prefetcher, const CBlockIndex& index, const node::BlockPrefetcher::NextBlockFn& next_fn) {
+        const auto block{prefetcher.Read(index, next_fn)};
+        BOOST_REQUIRE(block);
+        BOOST_CHECK_EQUAL(block->GetHash(), index.GetBlockHash());
+    }};
+
+    for (const size_t max_bytes : {size_t{1}, node::DEFAULT_BLOCK_PREFETCH_MAX_BYTES}) {
+        node::BlockPrefetcher prefetcher{blockman, /*workers=*/2, /*max_blocks=*/4, max_bytes};
+        for (const CBlockIndex* pindex{chain.Genesis()}; pindex; pindex = next(*pindex))
+            check_read(prefetcher, *pindex, next);
+        // Reading another block than the expected one restarts the walk from it
+        check_read(prefetcher, *chain[10], next);
+        check_read(prefetcher, *chain[50], next);
+        check_read(prefetcher, *chain[51], next);
+        check_read(prefetcher, *chain[40], [](const CBlockIndex& block) { return block.pprev; });
+        check_read(prefetcher, *chain[39], [](const CBlockIndex& block) { return block.pprev; });
+    }
+
+    // A block without data is left to the consumer
+    node::BlockPrefetcher prefetcher{blockman};
+    CBlockIndex index;
+    index.phashBlock = &uint256::ONE;
+    ASSERT_DEBUG_LOG("while reading raw block storage header");
+    BOOST_CHECK(!prefetcher.Read(index, next));
+}
+
 BOOST_FIXTURE_TEST_CASE(prune_lock_update_and_delete, TestingSetup)
 {
     LOCK(::cs_main);
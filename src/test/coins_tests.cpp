@@ -301,6 +301,45 @@ BOOST_FIXTURE_TEST_CASE(coins_cache_dbbase_simulation_test, CacheTest)
     SimulationTest(&db_base, true);
 }
 
+BOOST_FIXTURE_TEST_CASE(coins_cache_background_writer_simulation_test, CacheTest)
+{
+    CCoinsViewDB db_base{{.path = "test", .cache_bytes = 8_MiB, .memory_only = true}, {}};
+    CoinsViewBackgroundWriter writer{&db_base, /*background=*/true};
+    SimulationTest(&writer, true);
+}
+
+BOOST_AUTO_TEST_CASE(coins_background_writer)
+{
+    CCoinsViewDB db{{.path = "test", .cache_bytes = 1_MiB, .memory_only = true}, {}};
+    CoinsViewBackgroundWriter writer{&db, /*background=*/true};
+    CCoinsViewCache cache{&writer};
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 0};
+    cache.AddCoin(outpoint, Coin{CTxOut{1, CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/false);
+    const uint256 first_block{m_rng.rand256()};
+    cache.SetBestBlock(first_block);
+    cache.Flush();
+
+    // The flush is visible through the writer, whether or not it is already in the database
+    BOOST_CHECK(cache.HaveCoin(outpoint));
+    BOOST_CHECK_EQUAL(writer.GetBestBlock(), first_block);
+    writer.Wait();
+    BOOST_CHECK(db.HaveCoin(outpoint));
+    BOOST_CHECK_EQUAL(db.GetBestBlock(), first_block);
+
+    // The spend is only in the batch until it is written
+    cache.SpendCoin(outpoint);
+    const uint256 second_block{m_rng.rand256()};
+    cache.SetBestBlock(second_block);
+    cache.Sync();
+    BOOST_CHECK(!cache.HaveCoin(outpoint));
+    BOOST_CHECK(!writer.HaveCoin(outpoint));
+    BOOST_CHECK_EQUAL(writer.GetBestBlock(), second_block);
+    writer.Wait();
+    writer.ThrowIfFailed();
+    BOOST_CHECK(!db.HaveCoin(outpoint));
+    BOOST_CHECK_EQUAL(db.GetBestBlock(), second_block);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_FIXTURE_TEST_SUITE(coins_tests, BasicTestingSetup)
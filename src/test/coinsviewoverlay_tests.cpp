@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <optional>
 #include <ranges>
 
 BOOST_AUTO_TEST_SUITE(coinsviewoverlay_tests)
@@ -161,5 +162,37 @@ BOOST_AUTO_TEST_CASE(fetch_no_inputs)
     BOOST_CHECK_EQUAL(view.GetCacheSize(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(fetch_prefetched_inputs)
+{
+    const auto block{CreateBlock()};
+    CCoinsViewDB db{{.path = "", .cache_bytes = 1_MiB, .memory_only = true}, {}};
+    CCoinsViewCache main_cache{&db};
+    CoinsViewOverlay view{&main_cache};
+    const auto& missing{block.vtx[1]->vin[0].prevout};
+    {
+        const auto reset_guard{view.CreateResetGuard()};
+        std::vector<std::pair<COutPoint, std::optional<Coin>>> coins;
+        for (const auto& tx : block.vtx | std::views::drop(1)) {
+            for (const auto& in : tx->vin) {
+                Coin coin{};
+                coin.out.nValue = 2;
+                coins.emplace_back(in.prevout, in.prevout == missing ? std::nullopt : std::optional{std::move(coin)});
+            }
+        }
+        view.SetPrefetchedCoins(std::move(coins));
+        // The prefetched coins are used instead of the empty db
+        BOOST_CHECK(!view.HaveCoin(missing));
+        for (const auto& tx : block.vtx | std::views::drop(2)) {
+            for (const auto& in : tx->vin) {
+                BOOST_CHECK_EQUAL(view.AccessCoin(in.prevout).out.nValue, 2);
+            }
+        }
+        BOOST_CHECK(!main_cache.HaveCoinInCache(block.vtx[2]->vin[0].prevout));
+    }
+    // Reset drops the prefetched coins
+    BOOST_CHECK(!view.HaveCoin(block.vtx[2]->vin[0].prevout));
+    BOOST_CHECK_EQUAL(view.GetCacheSize(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
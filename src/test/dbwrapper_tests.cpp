@@ -2,7 +2,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/args.h>
 #include <dbwrapper.h>
+#include <logdb.h>
+#include <node/database_args.h>
 #include <test/util/common.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
@@ -10,28 +13,47 @@
 #include <util/byte_units.h>
 #include <util/string.h>
 
+#include <array>
+#include <map>
 #include <memory>
+#include <optional>
 #include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 using util::ToString;
 
+namespace {
+constexpr std::array ENGINES{DBEngineType::LEVELDB, DBEngineType::LOGDB};
+
+std::string LogDBKey(int i) { return strprintf("key%05d", i); }
+
+std::optional<std::string> LogDBRead(const LogDB& db, const std::string& key)
+{
+    return db.Read(MakeByteSpan(key));
+}
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(dbwrapper)
 {
-    // Perform tests both obfuscated and non-obfuscated.
+    // Perform tests with both engines, obfuscated and non-obfuscated.
+    for (const auto engine : ENGINES)
     for (const bool obfuscate : {false, true}) {
         constexpr size_t CACHE_SIZE{1_MiB};
-        const fs::path path{m_args.GetDataDirBase() / "dbwrapper"};
+        const fs::path path{m_args.GetDataDirBase() / fs::u8path("dbwrapper_" + DBEngineTypeToString(engine))};
+        const DBOptions options{.engine = engine};
 
         Obfuscation obfuscation;
         std::vector<std::pair<uint8_t, uint256>> key_values{};
 
         // Write values
         {
-            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .wipe_data = true, .obfuscate = obfuscate}};
+            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .wipe_data = true, .obfuscate = obfuscate, .options = options}};
             BOOST_CHECK_EQUAL(obfuscate, !dbw.IsEmpty());
 
             // Ensure that we're doing real obfuscation when obfuscate=true
@@ -48,13 +70,13 @@ BOOST_AUTO_TEST_CASE(dbwrapper)
 
         // Verify that the obfuscation key is never obfuscated
         {
-            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .obfuscate = false}};
+            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .obfuscate = false, .options = options}};
             BOOST_CHECK_EQUAL(obfuscation, dbwrapper_private::GetObfuscation(dbw));
         }
 
         // Read back the values
         {
-            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .obfuscate = obfuscate}};
+            CDBWrapper dbw{{.path = path, .cache_bytes = CACHE_SIZE, .obfuscate = obfuscate, .options = options}};
 
             // Ensure obfuscation is read back correctly
             BOOST_CHECK_EQUAL(obfuscation, dbwrapper_private::GetObfuscation(dbw));
@@ -153,10 +175,11 @@ BOOST_AUTO_TEST_CASE(dbwrapper_basic_data)
 // Test batch operations
 BOOST_AUTO_TEST_CASE(dbwrapper_batch)
 {
-    // Perform tests both obfuscated and non-obfuscated.
+    // Perform tests with both engines, obfuscated and non-obfuscated.
+    for (const auto engine : ENGINES)
     for (const bool obfuscate : {false, true}) {
         fs::path ph = m_args.GetDataDirBase() / (obfuscate ? "dbwrapper_batch_obfuscate_true" : "dbwrapper_batch_obfuscate_false");
-        CDBWrapper dbw({.path = ph, .cache_bytes = 1_MiB, .memory_only = true, .wipe_data = false, .obfuscate = obfuscate});
+        CDBWrapper dbw({.path = ph, .cache_bytes = 1_MiB, .memory_only = true, .wipe_data = false, .obfuscate = obfuscate, .options = {.engine = engine}});
 
         uint8_t key{'i'};
         uint256 in = m_rng.rand256();
@@ -196,10 +219,11 @@ BOOST_AUTO_TEST_CASE(dbwrapper_batch)
 
 BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
 {
-    // Perform tests both obfuscated and non-obfuscated.
+    // Perform tests with both engines, obfuscated and non-obfuscated.
+    for (const auto engine : ENGINES)
     for (const bool obfuscate : {false, true}) {
         fs::path ph = m_args.GetDataDirBase() / (obfuscate ? "dbwrapper_iterator_obfuscate_true" : "dbwrapper_iterator_obfuscate_false");
-        CDBWrapper dbw({.path = ph, .cache_bytes = 1_MiB, .memory_only = true, .wipe_data = false, .obfuscate = obfuscate});
+        CDBWrapper dbw({.path = ph, .cache_bytes = 1_MiB, .memory_only = true, .wipe_data = false, .obfuscate = obfuscate, .options = {.engine = engine}});
 
         // The two keys are intentionally chosen for ordering
         uint8_t key{'j'};
@@ -453,5 +477,244 @@ BOOST_AUTO_TEST_CASE(unicodepath)
     BOOST_CHECK(fs::exists(lockPath));
 }
 
+BOOST_AUTO_TEST_CASE(logdb_random_operations)
+{
+    for (const bool memory_only : {true, false}) {
+        const fs::path path{m_args.GetDataDirBase() / "logdb_random"};
+        std::map<std::string, std::string> reference;
+        // Small segments, so that they are often compacted
+        auto db{std::make_unique<LogDB>(path, memory_only, 4096)};
+        for (int round{0}; round < 200; ++round) {
+            auto batch{db->NewBatch()};
+            for (int i{0}; i < 20; ++i) {
+                const std::string key{LogDBKey(m_rng.randrange(300))};
+                if (m_rng.randbool()) {
+                    const std::string value(m_rng.randrange(64), char('a' + m_rng.randrange(26)));
+                    batch->Put(MakeByteSpan(key), MakeByteSpan(value));
+                    reference[key] = value;
+                } else {
+                    batch->Delete(MakeByteSpan(key));
+                    reference.erase(key);
+                }
+            }
+            db->Write(*batch, /*sync=*/false);
+            if (!memory_only && round % 50 == 49) {
+                // The index is rebuilt from the log
+                db.reset();
+                db = std::make_unique<LogDB>(path, memory_only, 4096);
+            }
+        }
+        for (int i{0}; i < 300; ++i) {
+            const std::string key{LogDBKey(i)};
+            const auto it{reference.find(key)};
+            BOOST_CHECK(LogDBRead(*db, key) == (it == reference.end() ? std::nullopt : std::optional{it->second}));
+            BOOST_CHECK_EQUAL(db->Exists(MakeByteSpan(key)), it != reference.end());
+        }
+        // Garbage is reclaimed as the log grows
+        db->ReclaimGarbage();
+        BOOST_CHECK_LE(db->TotalBytes(), 2 * db->LiveBytes() + 2 * 4096);
+
+        // Iteration is ordered, from the sought key
+        const auto it{db->NewIterator()};
+        it->Seek(MakeByteSpan(LogDBKey(150)));
+        for (auto expected{reference.lower_bound(LogDBKey(150))}; expected != reference.end(); ++expected, it->Next()) {
+            BOOST_REQUIRE(it->Valid());
+            BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(it->Key().data()), it->Key().size()), expected->first);
+            BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(it->Value().data()), it->Value().size()), expected->second);
+        }
+        BOOST_CHECK(!it->Valid());
+
+        db->CompactAll();
+        BOOST_CHECK_LE(db->TotalBytes(), db->LiveBytes() + 2 * 4096);
+        db.reset();
+        BOOST_CHECK(LogDB::Destroy(path));
+        BOOST_CHECK(!fs::exists(path));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(logdb_iterator)
+{
+    // Enough keys for the windows of the partitions to be refilled
+    LogDB db{m_args.GetDataDirBase() / "logdb_iterator", /*memory_only=*/true, 4096};
+    std::map<std::string, std::string> reference;
+    auto batch{db.NewBatch()};
+    for (int i{0}; i < 5000; ++i) {
+        const std::string key{LogDBKey(i)}, value{ToString(m_rng.rand64())};
+        batch->Put(MakeByteSpan(key), MakeByteSpan(value));
+        reference[key] = value;
+    }
+    db.Write(*batch, /*sync=*/false);
+
+    const auto it{db.NewIterator()};
+    it->Seek(MakeByteSpan(LogDBKey(1234)));
+    auto expected{reference.lower_bound(LogDBKey(1234))};
+    const auto check{[&] {
+        BOOST_REQUIRE(it->Valid());
+        BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(it->Key().data()), it->Key().size()), expected->first);
+        BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(it->Value().data()), it->Value().size()), expected->second);
+    }};
+    for (int i{0}; i < 100; ++i, ++expected, it->Next()) check();
+    // The values moved by a compaction while iterating are still found
+    db.CompactAll();
+    for (; expected != reference.end(); ++expected, it->Next()) check();
+    BOOST_CHECK(!it->Valid());
+}
+
+BOOST_AUTO_TEST_CASE(logdb_open_files)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb_open_files"};
+    const std::string value(4000, 'v');
+    const auto check{[&](const LogDB& db) {
+        for (size_t i{0}; i < 3 * LogDB::MAX_OPEN_FILES; ++i) BOOST_CHECK(LogDBRead(db, LogDBKey(i)) == value);
+        BOOST_CHECK_LE(LogDB::OpenFileCount(), LogDB::MAX_OPEN_FILES);
+    }};
+    {
+        // Each write fills a segment, so there are many more than the files which may be open at once
+        LogDB db{path, /*memory_only=*/false, 4096};
+        for (size_t i{0}; i < 3 * LogDB::MAX_OPEN_FILES; ++i) {
+            auto batch{db.NewBatch()};
+            batch->Put(MakeByteSpan(LogDBKey(i)), MakeByteSpan(value));
+            db.Write(*batch, /*sync=*/false);
+        }
+        BOOST_CHECK_GT(db.SegmentCount(), 2 * LogDB::MAX_OPEN_FILES);
+        check(db);
+    }
+    // Also when the segments are replayed
+    check(LogDB{path, /*memory_only=*/false, 4096});
+}
+
+BOOST_AUTO_TEST_CASE(logdb_torn_write)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb_torn"};
+    const std::string key1{"key1"}, key2{"key2"}, value(100, 'v');
+    {
+        LogDB db{path, /*memory_only=*/false, DBWRAPPER_MAX_FILE_SIZE};
+        for (const auto& key : {key1, key2}) {
+            auto batch{db.NewBatch()};
+            batch->Put(MakeByteSpan(key), MakeByteSpan(value));
+            db.Write(*batch, /*sync=*/true);
+        }
+    }
+    // Cut the last batch, as a crash in the middle of its write would
+    const fs::path segment{path / "000000.seg"};
+    fs::resize_file(segment, fs::file_size(segment) - 10);
+    {
+        LogDB db{path, /*memory_only=*/false, DBWRAPPER_MAX_FILE_SIZE};
+        BOOST_CHECK(LogDBRead(db, key1) == value);
+        BOOST_CHECK(!LogDBRead(db, key2));
+        // The torn batch was truncated, so the next ones are found after it
+        auto batch{db.NewBatch()};
+        batch->Put(MakeByteSpan(key2), MakeByteSpan(key1));
+        db.Write(*batch, /*sync=*/true);
+    }
+    LogDB db{path, /*memory_only=*/false, DBWRAPPER_MAX_FILE_SIZE};
+    BOOST_CHECK(LogDBRead(db, key1) == value);
+    BOOST_CHECK(LogDBRead(db, key2) == key1);
+}
+
+BOOST_AUTO_TEST_CASE(dbengine_mismatch)
+{
+    const fs::path path{m_args.GetDataDirBase() / "dbengine_mismatch"};
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1_MiB}};
+        dbw.Write(uint8_t{'k'}, uint256::ONE);
+    }
+    // The files of another engine are not mistaken for an empty database
+    BOOST_CHECK_THROW(CDBWrapper({.path = path, .cache_bytes = 1_MiB, .options = {.engine = DBEngineType::LOGDB}}), dbwrapper_error);
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1_MiB, .wipe_data = true, .options = {.engine = DBEngineType::LOGDB}}};
+        BOOST_CHECK(!dbw.Exists(uint8_t{'k'}));
+        dbw.Write(uint8_t{'k'}, uint256::ONE);
+    }
+    BOOST_CHECK_THROW(CDBWrapper({.path = path, .cache_bytes = 1_MiB}), dbwrapper_error);
+    BOOST_CHECK(DestroyDB(fs::PathToString(path)));
+    BOOST_CHECK(!fs::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_stats)
+{
+    for (const auto engine : ENGINES)
+    for (const int bloom_bits : {0, DEFAULT_DB_BLOOM_BITS}) {
+        const fs::path path{m_args.GetDataDirBase() / fs::u8path("dbwrapper_stats_" + DBEngineTypeToString(engine))};
+        {
+            CDBWrapper dbw{{.path = path, .cache_bytes = 1_MiB, .wipe_data = true, .options = {.engine = engine}}};
+            for (uint32_t i{0}; i < 1000; ++i) dbw.Write(i, uint256::ONE);
+        }
+        // Compacting moves the entries to files, which the lookups have to read
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1_MiB, .options = {.force_compact = true, .engine = engine, .bloom_bits = bloom_bits}}};
+
+        const DBStats before{dbw.GetStats()};
+        uint256 value;
+        for (uint32_t i{0}; i < 2000; ++i) BOOST_CHECK_EQUAL(dbw.Read(i, value), i < 1000);
+        const DBStats after{dbw.GetStats()};
+        BOOST_CHECK_EQUAL(after.lookups - before.lookups, 2000U);
+        BOOST_CHECK_GT(after.lookup_file_reads, before.lookup_file_reads);
+        BOOST_CHECK_GT(after.memory_usage, 0U);
+        uint64_t bytes{0};
+        for (const DBStats::Level& level : after.levels) bytes += level.bytes;
+        BOOST_CHECK_GT(bytes, 0U);
+
+        // Only LevelDB has bloom filters, which rule out most of the missing keys. Those
+        // outside of the key range of a table skip its filter.
+        BOOST_REQUIRE_EQUAL(after.bloom_checks.has_value(), engine == DBEngineType::LEVELDB && bloom_bits > 0);
+        if (after.bloom_checks) {
+            BOOST_CHECK_GE(*after.bloom_checks - *before.bloom_checks, 1000U);
+            BOOST_CHECK_GT(*after.bloom_rejections - *before.bloom_rejections, 900U);
+        }
+        if (engine == DBEngineType::LOGDB) {
+            BOOST_REQUIRE_EQUAL(after.levels.size(), 1U);
+            BOOST_CHECK_GT(after.levels[0].compaction_read_bytes, 0U);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_write_stalls)
+{
+    // With the smallest write buffer, the writes fill the memtable again long before the previous
+    // one is written to a file, so they have to wait for it
+    const fs::path path{m_args.GetDataDirBase() / "dbwrapper_write_stalls"};
+    CDBWrapper dbw{{.path = path, .cache_bytes = 1_MiB, .wipe_data = true, .options = {.engine = DBEngineType::LEVELDB, .write_buffer_size = 64 << 10}}};
+    BOOST_CHECK_EQUAL(dbw.GetStats().write_stalls, 0U);
+    const std::vector<unsigned char> value(1024);
+    for (uint32_t i{0}; i < 16'384; ++i) dbw.Write(i, value);
+    BOOST_CHECK_GT(dbw.GetStats().write_stalls, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_tuning_args)
+{
+    const auto read{[](std::vector<const char*> argv, std::string_view db_name) {
+        ArgsManager args;
+        for (const char* name : {"-dbbloombits", "-dbwritebuffersize", "-dbblockcachesize", "-dbmaxfilesize"}) {
+            args.AddArg(name, "", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+        }
+        argv.insert(argv.begin(), "ignored");
+        std::string error;
+        BOOST_REQUIRE(args.ParseParameters(argv.size(), argv.data(), error));
+        DBOptions options;
+        return node::ReadDatabaseArgs(args, options, db_name) ? std::optional{options} : std::nullopt;
+    }};
+
+    auto options{read({}, "chainstate")};
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->bloom_bits, DEFAULT_DB_BLOOM_BITS);
+    BOOST_CHECK(!options->write_buffer_size && !options->block_cache_size && !options->max_file_size);
+
+    // Values for a database take precedence over the ones for all of them, whatever their order
+    const std::vector<const char*> argv{"-dbbloombits=chainstate:0", "-dbbloombits=16", "-dbwritebuffersize=indexes:8", "-dbmaxfilesize=2"};
+    options = read(argv, "chainstate");
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->bloom_bits, 0);
+    BOOST_CHECK(!options->write_buffer_size);
+    BOOST_CHECK_EQUAL(*options->max_file_size, 2_MiB);
+    options = read(argv, "indexes");
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->bloom_bits, 16);
+    BOOST_CHECK_EQUAL(*options->write_buffer_size, 8_MiB);
+
+    BOOST_CHECK(!read({"-dbbloombits=wallet:10"}, "chainstate"));
+    BOOST_CHECK(!read({"-dbbloombits=33"}, "chainstate"));
+    BOOST_CHECK(!read({"-dbblockcachesize=blockindex:0"}, "chainstate"));
+    BOOST_CHECK(!read({"-dbmaxfilesize=chainstate:"}, "chainstate"));
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,8 @@
 #include <common/args.h>
 #include <net.h>
 #include <net_processing.h>
+#include <netmessagemaker.h>
+#include <protocol.h>
 #include <pubkey.h>
 #include <script/sign.h>
 #include <script/signingprovider.h>
@@ -405,6 +407,79 @@ BOOST_AUTO_TEST_CASE(peer_discouragement)
     connman->ClearTestNodes();
 }
 
+//! Send a ping to the node and return whether it was processed rather than deferred
+static bool ProcessPing(ConnmanTestMsg& connman, CNode& node) EXCLUSIVE_LOCKS_REQUIRED(NetEventsInterface::g_msgproc_mutex)
+{
+    // Drop what the node sent, so that the ping can be queued
+    connman.FlushSendBuffer(node);
+    (void)connman.ReceiveMsgFrom(node, NetMsg::Make(NetMsgType::PING, uint64_t{1}));
+    node.fPauseSend = false;
+    connman.ProcessMessagesOnce(node);
+    // A deferred message is still queued
+    return !node.PollMessage();
+}
+
+BOOST_AUTO_TEST_CASE(pow_check_budget_burst)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    NodeClockContext clock_ctx{};
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{ip(0xa0b0c001), NODE_NETWORK},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/1};
+    connman.Handshake(node, /*successfully_connected=*/true, ServiceFlags(NODE_NETWORK | NODE_WITNESS), ServiceFlags(NODE_NETWORK | NODE_WITNESS), PROTOCOL_VERSION, /*relay_txs=*/false);
+
+    // An inbound peer may use 0.25 s of PoW verification per second, in bursts of up to 30 s of it
+    m_node.peerman->UnitTestChargePoWCheckTime(node.GetId(), 7s);
+    BOOST_CHECK(ProcessPing(connman, node));
+    // Past the burst, its messages are deferred until the budget refills
+    m_node.peerman->UnitTestChargePoWCheckTime(node.GetId(), 1s);
+    BOOST_CHECK(!ProcessPing(connman, node));
+    clock_ctx += 1s;
+    BOOST_CHECK(!ProcessPing(connman, node));
+    clock_ctx += 2s;
+    BOOST_CHECK(ProcessPing(connman, node));
+
+    m_node.peerman->FinalizeNode(node);
+}
+
+BOOST_AUTO_TEST_CASE(pow_check_budget_outbound_sync)
+{
+    LOCK(NetEventsInterface::g_msgproc_mutex);
+    NodeClockContext clock_ctx{};
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+
+    CNode node{/*id=*/0,
+               /*sock=*/nullptr,
+               CAddress{ip(0xa0b0c001), NODE_NETWORK},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               CAddress{},
+               /*addrNameIn=*/"",
+               ConnectionType::OUTBOUND_FULL_RELAY,
+               /*inbound_onion=*/false,
+               /*network_key=*/1};
+    connman.Handshake(node, /*successfully_connected=*/true, ServiceFlags(NODE_NETWORK | NODE_WITNESS), ServiceFlags(NODE_NETWORK | NODE_WITNESS), PROTOCOL_VERSION, /*relay_txs=*/false);
+
+    // A syncing outbound peer keeps the message handler busy verifying its PoW, which the parallel checks of a batch
+    // are charged for by their wall-clock time, so at most one second per second, well below its rate of 4 s/s
+    for (int i{0}; i < 120; i++) {
+        m_node.peerman->UnitTestChargePoWCheckTime(node.GetId(), 1s);
+        BOOST_CHECK(ProcessPing(connman, node));
+        clock_ctx += 1s;
+    }
+
+    m_node.peerman->FinalizeNode(node);
+}
+
 BOOST_AUTO_TEST_CASE(DoS_bantime)
 {
     LOCK(NetEventsInterface::g_msgproc_mutex);
@@ -0,0 +1,139 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memusage.h>
+#include <support/allocators/pool.h>
+#include <test/util/poolresourcetester.h>
+#include <test/util/setup_common.h>
+#include <util/flatnodemap.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+//! Weak hash, so many keys share their tag and probe sequences are long
+struct CollidingHasher {
+    size_t operator()(uint64_t key) const noexcept { return (key % 37) * 0x9E3779B97F4A7C15ULL; }
+};
+
+template <typename Map>
+void CheckEqual(const Map& map, const std::map<uint64_t, uint64_t>& reference)
+{
+    BOOST_REQUIRE_EQUAL(map.size(), reference.size());
+    size_t iterated{0};
+    for (const auto& [key, value] : map) {
+        const auto it{reference.find(key)};
+        BOOST_REQUIRE(it != reference.end());
+        BOOST_CHECK_EQUAL(value, it->second);
+        ++iterated;
+    }
+    BOOST_CHECK_EQUAL(iterated, reference.size());
+}
+
+template <typename Map>
+void RandomOperations(Map& map, FastRandomContext& rng)
+{
+    std::map<uint64_t, uint64_t> reference;
+    std::map<uint64_t, const void*> addresses;
+    for (int i{0}; i < 20000; ++i) {
+        const uint64_t key{rng.randrange(uint64_t{2000})};
+        switch (rng.randrange(4)) {
+        case 0:
+        case 1: {
+            const uint64_t value{rng.rand64()};
+            const auto [it, inserted]{map.try_emplace(key, value)};
+            BOOST_CHECK_EQUAL(inserted, reference.try_emplace(key, value).second);
+            BOOST_CHECK_EQUAL(it->first, key);
+            if (inserted) addresses[key] = &*it;
+            break;
+        }
+        case 2:
+            BOOST_CHECK_EQUAL(map.erase(key), reference.erase(key));
+            addresses.erase(key);
+            break;
+        case 3: {
+            const auto it{map.find(key)};
+            BOOST_CHECK_EQUAL(it != map.end(), reference.contains(key));
+            if (it != map.end()) {
+                // Elements never move, even when the table is rehashed
+                BOOST_CHECK_EQUAL(&*it, addresses[key]);
+                BOOST_CHECK_EQUAL(it->second, reference[key]);
+            }
+            break;
+        }
+        }
+        if (i % 1000 == 0) CheckEqual(map, reference);
+    }
+    CheckEqual(map, reference);
+
+    // Erase while iterating, as with std::unordered_map
+    for (auto it{map.begin()}; it != map.end();) {
+        if (it->first % 2 == 0) {
+            reference.erase(it->first);
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    CheckEqual(map, reference);
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(flatnodemap_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(random_operations)
+{
+    FlatNodeMap<uint64_t, uint64_t> map;
+    RandomOperations(map, m_rng);
+    FlatNodeMap<uint64_t, uint64_t, CollidingHasher> colliding_map;
+    RandomOperations(colliding_map, m_rng);
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocated)
+{
+    using Map = FlatNodeMap<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                            PoolAllocator<std::pair<const uint64_t, uint64_t>, sizeof(std::pair<const uint64_t, uint64_t>)>>;
+    Map::allocator_type::ResourceType resource;
+    {
+        Map map{0, Map::hasher{}, Map::key_equal{}, &resource};
+        RandomOperations(map, m_rng);
+
+        // Growing the table by inserting is accounted for
+        const size_t usage_before{memusage::DynamicUsage(map)};
+        const uint64_t buckets{map.bucket_count()};
+        for (uint64_t key{2000}; key < 2000 + buckets; ++key) map[key] = key;
+        BOOST_CHECK_GT(memusage::DynamicUsage(map), usage_before);
+        BOOST_CHECK_GE(map.bucket_count() * 7 / 8, map.size());
+    }
+    PoolResourceTester::CheckAllDataAccountedFor(resource);
+}
+
+BOOST_AUTO_TEST_CASE(throwing_constructor)
+{
+    struct Throwing {
+        std::string value;
+        explicit Throwing(std::string v) : value{std::move(v)}
+        {
+            if (value.empty()) throw std::runtime_error{"empty"};
+        }
+    };
+    FlatNodeMap<uint64_t, Throwing> map;
+    for (uint64_t key{0}; key < 100; ++key) {
+        BOOST_CHECK_THROW(map.try_emplace(key, ""), std::runtime_error);
+        BOOST_CHECK(map.try_emplace(key, "x").second);
+    }
+    BOOST_CHECK_EQUAL(map.size(), 100U);
+    BOOST_CHECK(map.find(50) != map.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
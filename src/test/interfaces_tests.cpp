@@ -61,6 +61,22 @@ BOOST_FIXTURE_TEST_CASE(findBlock, TestChain100Setup)
     BOOST_CHECK(!chain->findBlock({}, FoundBlock()));
 }
 
+BOOST_FIXTURE_TEST_CASE(makeBlockReader, TestChain100Setup)
+{
+    LOCK(Assert(m_node.chainman)->GetMutex());
+    auto& chain = m_node.chain;
+    const CChain& active = Assert(m_node.chainman)->ActiveChain();
+
+    const auto reader{chain->makeBlockReader()};
+    // Blocks are read in order, then out of order
+    for (const int height : {0, 1, 2, 3, 50, 49, 100}) {
+        const auto block{reader->readBlock(active[height]->GetBlockHash())};
+        BOOST_REQUIRE(block);
+        BOOST_CHECK_EQUAL(block->GetHash(), active[height]->GetBlockHash());
+    }
+    BOOST_CHECK(!reader->readBlock({}));
+}
+
 BOOST_FIXTURE_TEST_CASE(findFirstBlockWithTimeAndHeight, TestChain100Setup)
 {
     LOCK(Assert(m_node.chainman)->GetMutex());
@@ -990,6 +990,50 @@ BOOST_AUTO_TEST_CASE(btck_check_block_context_free)
                           HasReason{"failed to instantiate btck object"});
 }
 
+BOOST_AUTO_TEST_CASE(btck_header_pow_verifier_tests)
+{
+    constexpr size_t NTIME_OFFSET{4 + 32 + 32};
+    constexpr size_t NNONCE_OFFSET{4 + 32 + 32 + 8 + 4};
+
+    // Regtest genesis header
+    auto genesis_header = hex_string_to_byte_vec("000000200000000000000000000000000000000000000000000000000000000000000000a6ccbab865135be2e8eabf5db58ea9e7ee6016dc0a81bbe666ff5632a6975249ca32c965000000000020010002001a0000000000000000000000000000000000000000000000000000000000");
+    BOOST_REQUIRE_EQUAL(genesis_header.size(), btck_BLOCK_HEADER_SERIALIZED_SIZE);
+    ChainParams regtest_params{ChainType::REGTEST};
+    auto consensus_params = regtest_params.GetConsensusParams();
+
+    // A different timestamp changes the PoW hash, so the genesis nonce is no longer a solution
+    auto bad_time_header = genesis_header;
+    bad_time_header[NTIME_OFFSET] ^= std::byte{0x01};
+    // An odd nonce selects the legacy PoW, whose Difficulty must be at least 304
+    auto bad_legacy_header = bad_time_header;
+    bad_legacy_header[NNONCE_OFFSET] |= std::byte{0x01};
+
+    std::vector<std::byte> raw_headers;
+    std::vector<bool> expected;
+    for (int i{0}; i < 64; ++i) {
+        const auto& header{i % 3 == 0 ? genesis_header : (i % 3 == 1 ? bad_time_header : bad_legacy_header)};
+        raw_headers.insert(raw_headers.end(), header.begin(), header.end());
+        expected.push_back(i % 3 == 0);
+    }
+
+    for (const unsigned int num_threads : {0U, 1U, 3U}) {
+        HeaderPoWVerifier verifier{num_threads};
+        BOOST_CHECK(verifier.Verify(consensus_params, raw_headers) == expected);
+        // The verifier can be reused, and checks each header on its own
+        BOOST_CHECK(verifier.Verify(consensus_params, genesis_header) == std::vector<bool>{true});
+        BOOST_CHECK(verifier.Verify(consensus_params, bad_time_header) == std::vector<bool>{false});
+        BOOST_CHECK(verifier.Verify(consensus_params, {}).empty());
+    }
+
+    HeaderPoWVerifier verifier{2};
+    std::vector<int> results(expected.size(), -1);
+    BOOST_CHECK_EQUAL(btck_header_pow_verifier_verify(verifier.get(), consensus_params.get(), raw_headers.data(), results.size(), results.data()), 22U);
+    for (size_t i{0}; i < results.size(); ++i) BOOST_CHECK_EQUAL(results[i], expected[i] ? 1 : 0);
+
+    raw_headers.pop_back();
+    BOOST_CHECK_THROW(verifier.Verify(consensus_params, raw_headers), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(btck_chainman_mainnet_tests)
 {
     auto test_directory{TestDirectory{"mainnet_test_bitcoin_kernel"}};
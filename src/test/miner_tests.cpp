@@ -32,6 +32,7 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/feefrac.h>
+#include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/time.h>
 #include <util/translation.h>
@@ -878,7 +879,7 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
             BOOST_REQUIRE_EQUAL(reason, "duplicate");
             BOOST_REQUIRE_EQUAL(debug, "");
         } else {
-            BOOST_REQUIRE(block_template->submitSolution(block.nVersion, block.nTime, block.nNonce, MakeTransactionRef(txCoinbase)));
+            BOOST_REQUIRE(block_template->submitSolution(block.nVersion, block.nTime, ArithToUint256(block.nNonce), MakeTransactionRef(txCoinbase)));
         }
         {
             LOCK(cs_main);
@@ -911,4 +912,73 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     TestPrioritisedMining(scriptPubKey, txFirst);
 }*/
 
+BOOST_AUTO_TEST_CASE(MineProofOfWork_test)
+{
+    // The sieve miner must find the same Proof of Work as a brute force search from the Target, regardless of the number of threads
+    const auto brute_force{[](CBlockHeader header, const Consensus::Params& params) {
+        header.nNonce = 2;
+        while (!CheckProofOfWorkImpl(header.GetHashForPoW(), header.nBits, ArithToUint256(header.nNonce), params)) header.nNonce += 131072;
+        return header.nNonce;
+    }};
+    util::SignalInterrupt interrupt;
+    const CChainParams& chain_params{m_node.chainman->GetParams()};
+    Consensus::Params params{chain_params.GetConsensus()};
+    params.hashGenesisBlockForPoW.SetNull();
+    CBlockHeader header{static_cast<const CBlockHeader&>(chain_params.GenesisBlock())};
+    // The main genesis block has a legacy nBits, use a small PoW Version 1 Difficulty instead so the brute force search stays fast
+    params.nBitsMin = 288*256;
+    header.nBits = params.nBitsMin;
+    const std::vector<std::vector<std::vector<int32_t>>> pattern_sets{{{0}}, {{0, 2}, {0, 4}}};
+    for (const auto& patterns : pattern_sets) {
+        params.powAcceptedPatterns = patterns;
+        for (uint32_t i{1}; i <= 3; i++) {
+            header.nTime = chain_params.GenesisBlock().nTime + i;
+            const arith_uint256 expected{brute_force(header, params)};
+            const uint64_t tries{((expected - 2) >> 17).GetLow64()};
+            for (const int threads : {1, 3}) {
+                CBlockHeader mined{header};
+                uint64_t max_tries{1000000};
+                BOOST_REQUIRE(node::MineProofOfWork(mined, params, max_tries, threads, interrupt));
+                BOOST_CHECK(mined.nNonce == expected);
+                BOOST_CHECK_EQUAL(max_tries, 1000000 - tries);
+            }
+            // The solution is after the maximum number of tries
+            CBlockHeader mined{header};
+            uint64_t max_tries{tries};
+            BOOST_CHECK(!node::MineProofOfWork(mined, params, max_tries, 1, interrupt));
+            BOOST_CHECK_EQUAL(max_tries, 0U);
+        }
+    }
+    uint64_t max_tries{1000000};
+    BOOST_REQUIRE(interrupt());
+    BOOST_CHECK(!node::MineProofOfWork(header, params, max_tries, 1, interrupt));
+}
+
+// Templates can only be created from the main chain once it uses the PoW Version 1, so use the regtest one
+BOOST_FIXTURE_TEST_CASE(submitSolution_full_nonce_test, RegTestingSetup)
+{
+    auto mining{interfaces::MakeMining(m_node, /*wait_loaded=*/false)};
+    BOOST_REQUIRE(mining);
+    BlockCreateOptions options{
+        .coinbase_output_script = CScript() << OP_TRUE,
+    };
+    auto block_template{mining->createNewBlock(options, /*cooldown=*/false)};
+    BOOST_REQUIRE(block_template);
+    CBlock block{block_template->getBlock()};
+    // The PoW commits to the Merkle Root that submitSolution recomputes
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    util::SignalInterrupt interrupt;
+    uint64_t max_tries{1000000};
+    BOOST_REQUIRE(node::MineProofOfWork(block, m_node.chainman->GetParams().GetConsensus(), max_tries, 1, interrupt));
+
+    // The high bits of the nonce must reach the block: here they put the offset out of range
+    const uint256 bad_nonce{ArithToUint256(block.nNonce + (arith_uint256{1} << 200))};
+    BOOST_CHECK(!block_template->submitSolution(block.nVersion, block.nTime, bad_nonce, block.vtx[0]));
+    BOOST_CHECK(block_template->submitSolution(block.nVersion, block.nTime, ArithToUint256(block.nNonce), block.vtx[0]));
+    LOCK(cs_main);
+    const CBlockIndex* tip{Assert(m_node.chainman)->ActiveChain().Tip()};
+    BOOST_CHECK_EQUAL(tip->GetBlockHash(), block.GetHash());
+    BOOST_CHECK(tip->nNonce == block.nNonce);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <consensus/params.h>
+#include <kernel/types.h>
+#include <node/mining_power.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace {
+struct MiningPowerTestingSetup : public ChainTestingSetup {
+    Consensus::Params params;
+    //! Block indexes and their hashes need stable addresses
+    std::deque<CBlockIndex> blocks;
+    std::deque<uint256> hashes;
+
+    MiningPowerTestingSetup()
+    {
+        params = m_node.chainman->GetConsensus();
+        // Fork 2 in the middle of the test chains, with a small minimum Difficulty
+        params.fork2Height = 200;
+        params.nBitsMin = 16*256;
+        params.powAcceptedPatterns = {{0, 2, 4, 2, 4, 6, 2}};
+    }
+
+    double Difficulty(const CBlockIndex& block) const
+    {
+        return params.GetPoWVersionAtHeight(block.nHeight) == -1 ? (block.nBits & 0x007FFFFFU) >> 8U : block.nBits/256.;
+    }
+
+    const CBlockIndex* Extend(const CBlockIndex* tip, int count)
+    {
+        for (int i{0}; i < count; i++) {
+            CBlockIndex& block{blocks.emplace_back()};
+            block.phashBlock = &hashes.emplace_back(m_rng.rand256());
+            block.pprev = const_cast<CBlockIndex*>(tip);
+            block.nHeight = tip ? tip->nHeight + 1 : 0;
+            // Timestamps are not monotonic, so the window extremes are not always at its ends
+            block.nTime = 1707684554 + 150*block.nHeight + m_rng.randrange(1201) - 600;
+            block.nBits = (16 + m_rng.randrange(16))*256 + (block.nHeight >= params.fork2Height ? m_rng.randrange(256) : 0);
+            const double proof(std::pow(Difficulty(block), params.GetConstellationSizeAtHeight(block.nHeight) + 2.3));
+            block.nChainWork = (tip ? tip->nChainWork : arith_uint256{}) + arith_uint256{static_cast<uint64_t>(proof)};
+            block.BuildSkip();
+            tip = &block;
+        }
+        return tip;
+    }
+
+    //! Walk the window as the original getnetworkminingpower implementation
+    double ReferenceMiningPower(const CBlockIndex* pb, int lookup) const
+    {
+        if (!pb->nHeight)
+            return 0.;
+        lookup = std::min(lookup, pb->nHeight);
+        int64_t minTime(pb->GetBlockTime()), maxTime(minTime);
+        double miningPower(0.);
+        for (int i = 0; i < lookup; i++) {
+            miningPower += std::pow(Difficulty(*pb)/(params.nBitsMin/256.), params.GetConstellationSizeAtHeight(pb->nHeight) + 2.3);
+            pb = pb->pprev;
+            minTime = std::min(pb->GetBlockTime(), minTime);
+            maxTime = std::max(pb->GetBlockTime(), maxTime);
+        }
+        if (minTime == maxTime)
+            return 0.;
+        return (params.nPowTargetSpacing*lookup/static_cast<double>(maxTime - minTime))*(miningPower/lookup);
+    }
+
+    void CheckEstimates(node::MiningPowerEstimator& estimator, const CBlockIndex* tip)
+    {
+        for (int i{0}; i < 200; i++) {
+            const int height(m_rng.randrange(tip->nHeight + 2) - 1);
+            const int lookup(1 + m_rng.randrange(i % 2 ? 2000 : 150));
+            const double expected(ReferenceMiningPower(height < 0 ? tip : tip->GetAncestor(height), lookup));
+            BOOST_CHECK_CLOSE(estimator.Estimate(*tip, height, lookup), expected, 1e-6);
+        }
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(mining_power_tests, MiningPowerTestingSetup)
+
+BOOST_AUTO_TEST_CASE(estimate_from_queries)
+{
+    node::MiningPowerEstimator estimator{params};
+    const CBlockIndex* tip{Extend(nullptr, 1000)};
+    BOOST_CHECK_EQUAL(estimator.Estimate(*tip, 0, 100), 0.);
+    CheckEstimates(estimator, tip);
+
+    // Queries catch up with reorganizations, at or away from chunk boundaries
+    for (const int fork_height : {640, 700, 999}) {
+        const CBlockIndex* branch_tip{Extend(tip->GetAncestor(fork_height), 1000 - fork_height + 77)};
+        CheckEstimates(estimator, branch_tip);
+        CheckEstimates(estimator, tip);
+        // Older tips of the tracked chain are answered without rewinding it
+        CheckEstimates(estimator, tip->GetAncestor(fork_height - 100));
+        CheckEstimates(estimator, tip);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(estimate_from_validation_signals)
+{
+    node::MiningPowerEstimator estimator{params};
+    m_node.validation_signals->RegisterValidationInterface(&estimator);
+    const auto block{std::make_shared<const CBlock>()};
+    const CBlockIndex* tip{Extend(nullptr, 500)};
+    // Blocks connected before the first query are not tracked
+    m_node.validation_signals->BlockConnected(kernel::ChainstateRole{}, block, tip->GetAncestor(0));
+    CheckEstimates(estimator, tip->GetAncestor(100));
+    for (int height{101}; height <= 200; height++) {
+        m_node.validation_signals->BlockConnected(kernel::ChainstateRole{}, block, tip->GetAncestor(height));
+    }
+    // A gap in the connected blocks is filled from the block index
+    m_node.validation_signals->BlockConnected(kernel::ChainstateRole{}, block, tip);
+    const CBlockIndex* branch_tip{Extend(tip->GetAncestor(300), 250)};
+    for (int height{tip->nHeight}; height > 300; height--) {
+        m_node.validation_signals->BlockDisconnected(block, tip->GetAncestor(height));
+    }
+    for (int height{301}; height <= branch_tip->nHeight; height++) {
+        m_node.validation_signals->BlockConnected(kernel::ChainstateRole{}, block, branch_tip->GetAncestor(height));
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    m_node.validation_signals->UnregisterValidationInterface(&estimator);
+    CheckEstimates(estimator, branch_tip);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
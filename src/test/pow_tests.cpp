@@ -3,9 +3,11 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <pow.h>
+#include <primitives/block.h>
 #include <test/util/random.h>
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
@@ -13,6 +15,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+
 BOOST_FIXTURE_TEST_SUITE(pow_tests, BasicTestingSetup)
 
 /* Test calculation of next difficulty target with no constraints applying */
@@ -101,6 +105,150 @@ BOOST_AUTO_TEST_CASE(CheckProofOfWork_test_zero_target)
     BOOST_CHECK(!CheckProofOfWork(hash, 0, offset, consensus));
 }
 
+BOOST_AUTO_TEST_CASE(GetPrimorial_test)
+{
+    BOOST_CHECK(GetPrimorial(0) == 1);
+    BOOST_CHECK(GetPrimorial(1) == 2);
+    BOOST_CHECK(GetPrimorial(5) == 2310);
+    BOOST_CHECK(GetPrimorial(5, mpz_class{2310}) == 2310);
+    BOOST_CHECK(!GetPrimorial(5, mpz_class{2309}));
+    BOOST_CHECK(!GetPrimorial(40, mpz_class{2309}));
+    // Compare with a naive computation, including beyond the cached Primorials
+    for (const uint16_t primorialNumber : {2, 40, 40, 127, 1024, 1025, 1500}) {
+        mpz_class expected{1};
+        for (uint16_t i = 0; i < primorialNumber; i++) expected *= static_cast<unsigned long>(primeTable[i]);
+        BOOST_CHECK(GetPrimorial(primorialNumber) == expected);
+        BOOST_CHECK(GetPrimorial(primorialNumber, expected) == expected);
+        BOOST_CHECK(!GetPrimorial(primorialNumber, mpz_class{expected - 1}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DeriveTarget_legacy_test)
+{
+    // Target = 1 . 00000000 . hash . 00...0, with the Hash bits in reverse order
+    uint256 hash;
+    hash.begin()[0] = 0x01;
+    hash.begin()[31] = 0xC0;
+    const unsigned int nBits(0x02013000); // Difficulty 304
+    const std::optional<mpz_class> target(DeriveTarget(hash, nBits, 0, -1, 288*256));
+    BOOST_REQUIRE(target);
+    mpz_class expected{256};
+    expected <<= 256;
+    expected += (mpz_class{1} << 255) + 3;
+    expected <<= 304 - 265;
+    BOOST_CHECK(*target == expected);
+    BOOST_CHECK_EQUAL(mpz_sizeinbase(target->get_mpz_t(), 2), 304U);
+}
+
+BOOST_AUTO_TEST_CASE(IsFermatProbablePrime_test)
+{
+    // Compare with a plain Modular Exponentiation for random odd numbers of various sizes
+    for (int i = 0; i < 1000; i++) {
+        const std::vector<unsigned char> bytes{m_rng.randbytes(1 + m_rng.randrange(160))};
+        mpz_class n;
+        mpz_import(n.get_mpz_t(), bytes.size(), 1, 1, 0, 0, bytes.data());
+        n |= 1;
+        if (n < 3) continue;
+        mpz_class expected;
+        const mpz_class two{2}, exponent{n - 1};
+        mpz_powm(expected.get_mpz_t(), two.get_mpz_t(), exponent.get_mpz_t(), n.get_mpz_t());
+        BOOST_CHECK_EQUAL(IsFermatProbablePrime(n), expected == 1);
+    }
+    BOOST_CHECK(IsFermatProbablePrime(mpz_class{"4294967291"}));
+    BOOST_CHECK(IsFermatProbablePrime(mpz_class{"341"})); // Base 2 Pseudoprime
+    BOOST_CHECK(!IsFermatProbablePrime(mpz_class{"4294967293"}));
+}
+
+BOOST_AUTO_TEST_CASE(CheckConstellations_test)
+{
+    const std::vector<std::vector<int32_t>> septupletPatterns{{0, 2, 4, 2, 4, 6, 2}, {0, 2, 6, 4, 2, 4, 2}},
+                                            quintupletPatterns{{0, 4, 2, 4, 2}, {0, 2, 4, 2, 4}},
+                                            sextupletPattern{{0, 4, 2, 4, 2, 4}};
+    const mpz_class septuplet1{"1000000000000000d6c00798f", 16}, septuplet2{"10000000000000008927e1809", 16},
+                    quintuplet{"fffffffffffffffffffc69721", 16}, sextuplet{"100000000000070556fc1", 16};
+    BOOST_CHECK(CheckConstellations(septuplet1, septupletPatterns));
+    BOOST_CHECK(CheckConstellations(septuplet2, septupletPatterns));
+    BOOST_CHECK(CheckConstellations(septuplet1, {septupletPatterns[0]}));
+    BOOST_CHECK(!CheckConstellations(septuplet1, {septupletPatterns[1]}));
+    BOOST_CHECK(!CheckConstellations(septuplet2, {septupletPatterns[0]}));
+    BOOST_CHECK(!CheckConstellations(septuplet1 + 2, septupletPatterns));
+    BOOST_CHECK(!CheckConstellations(septuplet1 - 30030, septupletPatterns));
+    BOOST_CHECK(CheckConstellations(quintuplet, quintupletPatterns));
+    BOOST_CHECK(!CheckConstellations(quintuplet + 4, quintupletPatterns));
+    BOOST_CHECK(CheckConstellations(sextuplet, sextupletPattern));
+    BOOST_CHECK(!CheckConstellations(sextuplet, septupletPatterns));
+    // Tuple elements are also Primes on their own
+    BOOST_CHECK(CheckConstellations(septuplet1 + 20, {{0}}));
+    BOOST_CHECK(!CheckConstellations(septuplet1 + 22, {{0}}));
+    // The Sieve alone keeps the Constellations, but rejects elements with small factors
+    BOOST_CHECK(CheckConstellations(septuplet1, septupletPatterns, /*sieveOnly=*/true));
+    BOOST_CHECK(CheckConstellations(quintuplet, quintupletPatterns, /*sieveOnly=*/true));
+    BOOST_CHECK(!CheckConstellations(septuplet1 + 1, septupletPatterns, /*sieveOnly=*/true));
+    BOOST_CHECK(!CheckConstellations(septuplet1 + 3, {{0}}, /*sieveOnly=*/true));
+
+    // Compare with Primality Tests of each element for random numbers
+    for (int i = 0; i < 1000; i++) {
+        const std::vector<unsigned char> bytes{m_rng.randbytes(8 + m_rng.randrange(24))};
+        mpz_class n;
+        mpz_import(n.get_mpz_t(), bytes.size(), 1, 1, 0, 0, bytes.data());
+        bool expected(false);
+        for (const auto& pattern : quintupletPatterns) {
+            mpz_class element{n};
+            bool patternFound(true);
+            for (const int32_t offset : pattern) {
+                element += offset;
+                patternFound = patternFound && mpz_probab_prime_p(element.get_mpz_t(), 31) != 0;
+            }
+            expected = expected || patternFound;
+        }
+        BOOST_CHECK_EQUAL(CheckConstellations(n, quintupletPatterns), expected);
+        BOOST_CHECK(!expected || CheckConstellations(n, quintupletPatterns, /*sieveOnly=*/true));
+        BOOST_CHECK_EQUAL(CheckConstellations(n, {{0}}), mpz_probab_prime_p(n.get_mpz_t(), 31) != 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PreScreenProofOfWork_test)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, ChainType::REGTEST);
+    Consensus::Params params{chainParams->GetConsensus()};
+    params.hashGenesisBlockForPoW.SetNull();
+    params.powAcceptedPatterns = {{0, 2}, {0, 4}};
+    CBlockHeader header{chainParams->GenesisBlock()};
+    const uint256 hash(header.GetHashForPoW());
+    // The Pre-Screen never rejects a valid PoW, and rejects most candidates before any Primality Test
+    int candidates(0), preScreened(0);
+    for (header.nNonce = 2; ; header.nNonce += 131072) { // Primorial Offset 2k
+        candidates++;
+        const bool preScreen(PreScreenProofOfWork(hash, header.nBits, ArithToUint256(header.nNonce), params));
+        preScreened += preScreen;
+        if (CheckProofOfWork(hash, header.nBits, ArithToUint256(header.nNonce), params)) {
+            BOOST_CHECK(preScreen);
+            break;
+        }
+    }
+    BOOST_CHECK_LT(preScreened*5, candidates);
+    // Structural and Offset limit failures
+    BOOST_CHECK(!PreScreenProofOfWork(hash, header.nBits, ArithToUint256(header.nNonce + 1), params));
+    BOOST_CHECK(!PreScreenProofOfWork(hash, header.nBits, ArithToUint256(header.nNonce + (arith_uint256{1} << 200)), params));
+    BOOST_CHECK(!PreScreenProofOfWork(hash, params.nBitsMin - 1, ArithToUint256(header.nNonce), params));
+
+    // The time spent is accounted to the innermost scope
+    std::atomic<int64_t> outerCost(0), innerCost(0);
+    BOOST_CHECK(!PoWCostScope::Current());
+    {
+        const PoWCostScope outerScope(&outerCost);
+        {
+            const PoWCostScope innerScope(&innerCost);
+            BOOST_CHECK_EQUAL(PoWCostScope::Current(), &innerCost);
+            BOOST_CHECK(CheckProofOfWork(hash, header.nBits, ArithToUint256(header.nNonce), params));
+        }
+        BOOST_CHECK_EQUAL(PoWCostScope::Current(), &outerCost);
+    }
+    BOOST_CHECK(!PoWCostScope::Current());
+    BOOST_CHECK_GT(innerCost.load(), 0);
+    BOOST_CHECK_EQUAL(outerCost.load(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
 {
     const auto chainParams = CreateChainParams(*m_node.args, ChainType::MAIN);
@@ -1057,6 +1057,39 @@ BOOST_AUTO_TEST_CASE(checktxinputs_invalid_transactions_test)
                   TxValidationResult::TX_PREMATURE_SPEND, /*expected_reason=*/"bad-txns-premature-spend-of-coinbase");
 }
 
+BOOST_AUTO_TEST_CASE(checktxinputs_disabled_scripts_test)
+{
+    auto check{[](const CScript& script, int spend_height) {
+        CCoinsViewCache inputs{&CoinsViewEmpty::Get()};
+
+        const COutPoint prevout{Txid::FromUint256(uint256::ONE), 0};
+        inputs.AddCoin(prevout, Coin{{1 * COIN, script}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(prevout);
+        // Leave a fee, as a minimum one is enforced
+        mtx.vout.emplace_back(COIN / 2, CScript() << OP_TRUE);
+
+        TxValidationState state;
+        CAmount txfee{0};
+        const bool valid{Consensus::CheckTxInputs(CTransaction{mtx}, state, inputs, spend_height, txfee)};
+        BOOST_CHECK(valid || state.GetRejectReason() == "bad-txns-disabled-script");
+        return valid;
+    }};
+
+    const CScript poloniex{CScript() << OP_DUP << OP_HASH160 << "7f8e8b4e8d14e867987a62242bc25458ec8a2b94"_hex << OP_EQUALVERIFY << OP_CHECKSIG};
+    const CScript xeggex{CScript() << OP_1 << "b4b4f66c2920b8425e99e8f1e89597d1e7307b4de1c91b0337830c4218b4fd75"_hex};
+    const CScript specTrade{CScript() << OP_1 << "c19e658a0ed6120f8db45a28bce492e1c95700809127ee5e152995784b548b24"_hex};
+    const CScript other{CScript() << OP_1 << "c19e658a0ed6120f8db45a28bce492e1c95700809127ee5e152995784b548b25"_hex};
+    BOOST_CHECK(check(poloniex, 2474000));
+    BOOST_CHECK(!check(poloniex, 2474001));
+    BOOST_CHECK(check(xeggex, 2474000));
+    BOOST_CHECK(!check(xeggex, 2474001));
+    BOOST_CHECK(check(specTrade, 2662380));
+    BOOST_CHECK(!check(specTrade, 2662381));
+    BOOST_CHECK(check(other, 3000000));
+}
+
 BOOST_AUTO_TEST_CASE(getvalueout_out_of_range_throws)
 {
     CMutableTransaction mtx;
@@ -22,11 +22,14 @@
 #include <txmempool.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/time.h>
 #include <validation.h>
 #include <validationinterface.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -384,4 +387,90 @@ BOOST_AUTO_TEST_CASE(witness_commitment_index)
 
     BOOST_CHECK_EQUAL(GetWitnessCommitmentIndex(pblock), 2);
 }
+
+//! Chain of Headers with a valid PoW on top of the Genesis Block
+static std::vector<CBlockHeader> MineHeaders(int count)
+{
+    const CBlock& genesis{Params().GenesisBlock()};
+    std::vector<CBlockHeader> headers;
+    for (int i(0) ; i < count ; i++) {
+        CBlockHeader header;
+        header.nVersion = genesis.nVersion;
+        header.hashPrevBlock = headers.empty() ? genesis.GetHash() : headers.back().GetHash();
+        header.hashMerkleRoot = uint256::ONE;
+        header.nTime = genesis.nTime + i + 1;
+        header.nBits = genesis.nBits;
+        header.nNonce = UintToArith256(uint256{"0000000000000000000000000000000000000000000000000000000000000002"});
+        while (!CheckProofOfWork(header.GetHashForPoW(), header.nBits, ArithToUint256(header.nNonce), Params().GetConsensus()))
+            header.nNonce += 131072;
+        headers.push_back(header);
+    }
+    return headers;
+}
+
+BOOST_AUTO_TEST_CASE(process_new_block_headers_batch_pow)
+{
+    // Build a Batch of Headers whose PoW is checked in parallel by the PoW Check Queue, and invalidate the PoW of one of them
+    const std::vector<CBlockHeader> headers{MineHeaders(16)};
+    const size_t invalidIndex(10);
+    std::vector<CBlockHeader> invalidHeaders(headers.begin(), headers.begin() + invalidIndex + 1);
+    do {
+        invalidHeaders.back().nNonce += 131072;
+    } while (CheckProofOfWork(invalidHeaders.back().GetHashForPoW(), invalidHeaders.back().nBits, ArithToUint256(invalidHeaders.back().nNonce), Params().GetConsensus()));
+
+    // The Headers before the invalid one are accepted, and the State is the one of the invalid Header
+    BlockValidationState state;
+    const CBlockIndex* pindex{nullptr};
+    BOOST_CHECK(!m_node.chainman->ProcessNewBlockHeaders(invalidHeaders, state, &pindex));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "short-constellation");
+    BOOST_REQUIRE(pindex);
+    BOOST_CHECK_EQUAL(pindex->GetBlockHash(), headers[invalidIndex - 1].GetHash());
+    BOOST_CHECK(WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(invalidHeaders.back().GetHash())) == nullptr);
+
+    // The valid Batch is fully accepted, including the already known Headers
+    state = BlockValidationState{};
+    BOOST_CHECK(m_node.chainman->ProcessNewBlockHeaders(headers, state, &pindex));
+    BOOST_CHECK_EQUAL(pindex->GetBlockHash(), headers.back().GetHash());
+    BOOST_CHECK_EQUAL(pindex->nHeight, static_cast<int>(headers.size()));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return m_node.chainman->m_best_header->GetBlockHash()), headers.back().GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(process_new_block_headers_batch_pow_cost)
+{
+    // The Batch is verified by the workers of the PoW Check Queue, and the waiting thread accounts its wall-clock time rather than the sum of the time of all the threads,
+    // so a peer syncing Headers is not charged several seconds of PoW verification per second
+    const std::vector<CBlockHeader> headers{MineHeaders(64)};
+    std::atomic<int64_t> cost{0};
+    BlockValidationState state;
+    const auto time_start{SteadyClock::now()};
+    {
+        const PoWCostScope powCostScope{&cost};
+        BOOST_CHECK(m_node.chainman->ProcessNewBlockHeaders(headers, state, /*ppindex=*/nullptr));
+    }
+    const auto elapsed{SteadyClock::now() - time_start};
+    BOOST_CHECK_GT(cost.load(), 0);
+    BOOST_CHECK_LE(cost.load(), Ticks<std::chrono::microseconds>(elapsed));
+}
+
+BOOST_AUTO_TEST_CASE(process_new_block_indexed_header_pow)
+{
+    // Build a Block with an invalid PoW
+    auto pblock{Block(Params().GenesisBlock().GetHash())};
+    m_node.chainman->GenerateCoinbaseCommitment(*pblock, WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip()));
+    pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+    pblock->nNonce = UintToArith256(uint256{"0000000000000000000000000000000000000000000000000000000000000002"});
+    while (CheckProofOfWork(pblock->GetHashForPoW(), pblock->nBits, ArithToUint256(pblock->nNonce), Params().GetConsensus()))
+        pblock->nNonce += 131072;
+
+    // It is rejected while its Header is unknown
+    BOOST_CHECK(!m_node.chainman->ProcessNewBlock(std::make_shared<const CBlock>(*pblock), /*force_processing=*/true, /*new_block=*/nullptr));
+    BOOST_CHECK(WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(pblock->GetHash())) == nullptr);
+
+    // Once its Header is in the Block Index, whose Headers all had their PoW verified, neither ProcessNewBlock nor AcceptBlock check the PoW again, so the Block is connected
+    WITH_LOCK(::cs_main, m_node.chainman->m_blockman.AddToBlockIndex(*pblock, m_node.chainman->m_best_header));
+    bool new_block{false};
+    BOOST_CHECK(m_node.chainman->ProcessNewBlock(pblock, /*force_processing=*/true, &new_block));
+    BOOST_CHECK(new_block);
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip()->GetBlockHash()), pblock->GetHash());
+}
 BOOST_AUTO_TEST_SUITE_END()
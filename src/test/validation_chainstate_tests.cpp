@@ -17,6 +17,7 @@
 #include <test/util/chainstate.h>
 #include <test/util/coins.h>
 #include <test/util/common.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <tinyformat.h>
 #include <uint256.h>
@@ -98,6 +99,46 @@ BOOST_FIXTURE_TEST_CASE(connect_tip_does_not_cache_inputs_on_failed_connect, Tes
     BOOST_CHECK(!chainstate.CoinsTip().HaveCoinInCache(outpoint));    // input not cached
 }
 
+BOOST_FIXTURE_TEST_CASE(prefetch_coins_skips_unflushed_spends, TestChain100Setup)
+{
+    Chainstate& chainstate{Assert(m_node.chainman)->ActiveChainstate()};
+
+    // Two coins in the coins database, none in the cache
+    std::vector<COutPoint> outpoints;
+    {
+        LOCK(cs_main);
+        for (int i{0}; i < 2; ++i) {
+            outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), /*nIn=*/0);
+            chainstate.CoinsTip().AddCoin(outpoints.back(), Coin{CTxOut{COIN, CScript{} << OP_TRUE}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+        }
+        chainstate.CoinsTip().Flush(/*reallocate_cache=*/false);
+    }
+    const auto spend{[](const COutPoint& outpoint, CAmount value) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(outpoint);
+        tx.vout.emplace_back(value, CScript{} << OP_TRUE);
+        return tx;
+    }};
+
+    // Spend the first coin, leaving a spent entry in the cache while the database still has the coin
+    CreateAndProcessBlock({spend(outpoints[0], COIN / 2)}, CScript{} << OP_TRUE);
+    const auto tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(!chainstate.CoinsTip().HaveCoinInCache(outpoints[0]));
+        BOOST_CHECK(chainstate.CoinsTip().HaveEntryInCache(outpoints[0]));
+        BOOST_CHECK(chainstate.CoinsDB().HaveCoin(outpoints[0]));
+    }
+
+    // A block spending it again along with the second coin only prefetches the second one, and is rejected
+    {
+        ASSERT_DEBUG_LOG("Prefetch 1 coins");
+        CreateAndProcessBlock({spend(outpoints[0], COIN / 4), spend(outpoints[1], COIN / 2)}, CScript{} << OP_TRUE);
+    }
+    LOCK(cs_main);
+    BOOST_CHECK_EQUAL(tip, chainstate.m_chain.Tip()->GetBlockHash());
+}
+
 //! Test UpdateTip behavior for both active and background chainstates.
 //!
 //! When run on the background chainstate, UpdateTip should do a subset
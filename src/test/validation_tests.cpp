@@ -125,6 +125,55 @@ BOOST_AUTO_TEST_CASE(test_assumeutxo)
     BOOST_CHECK_EQUAL(out110_2.m_chain_tx_count, 111U);
 }
 
+//! Test recognition of Known Header Batches, including when the Headers are not aligned with the Batches.
+BOOST_AUTO_TEST_CASE(test_known_header_batches)
+{
+    std::vector<CBlockHeader> headers(10);
+    for (size_t i{0}; i < headers.size(); i++) {
+        headers[i].nTime = i;
+        headers[i].nBits = 288*256;
+        headers[i].nNonce = i;
+        if (i > 0) headers[i].hashPrevBlock = headers[i - 1].GetHash();
+    }
+    const auto batch_hash{[&](size_t start, size_t size) {
+        HashWriter hasher{};
+        for (size_t i{start}; i < start + size; i++) hasher << headers[i];
+        return hasher.GetHash();
+    }};
+    // Headers at Heights 1-4 and 5-8 are known, the ones at Heights 9 and 10 are not
+    const CheckpointData checkpoints{{{batch_hash(0, 4), {1, 4}}, {batch_hash(4, 4), {5, 4}}}, headers[7].GetHash(), 8};
+    const std::span<const CBlockHeader> all{headers};
+
+    BOOST_CHECK(checkpoints.isKnownHeaderBatch(all.subspan(0, 4), 1));
+    BOOST_CHECK(checkpoints.isKnownHeaderBatch(all.subspan(4, 4), 5));
+    BOOST_CHECK(!checkpoints.isKnownHeaderBatch(all.subspan(4, 4), 1));
+    BOOST_CHECK(!checkpoints.isKnownHeaderBatch(all.subspan(0, 3), 1));
+
+    BOOST_CHECK_EQUAL(checkpoints.getHeaderBatchStart(1).value(), 1U);
+    BOOST_CHECK_EQUAL(checkpoints.getHeaderBatchStart(4).value(), 1U);
+    BOOST_CHECK_EQUAL(checkpoints.getHeaderBatchStart(6).value(), 5U);
+    BOOST_CHECK(!checkpoints.getHeaderBatchStart(9));
+
+    // Aligned
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, all, 1), 8U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, all.subspan(4), 5), 4U);
+    // Only complete Batches are recognized
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, all.subspan(0, 7), 1), 4U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, all.subspan(0, 3), 1), 0U);
+    // Not aligned, with the beginning of the first Batch provided
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders(all.subspan(0, 2), all.subspan(2), 3), 6U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders(all.subspan(4, 1), all.subspan(5, 3), 6), 3U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders(all.subspan(0, 2), all.subspan(2, 2), 3), 2U);
+    // Not aligned, without the beginning of the first Batch
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, all.subspan(2), 3), 0U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders(all.subspan(1, 1), all.subspan(2), 3), 0U);
+    // A different Header makes its Batch and the following ones unknown
+    std::vector<CBlockHeader> modified{headers};
+    modified[5].nTime++;
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders({}, modified, 1), 4U);
+    BOOST_CHECK_EQUAL(checkpoints.countKnownHeaders(std::span{modified}.subspan(0, 2), std::span{modified}.subspan(2), 3), 2U);
+}
+
 BOOST_AUTO_TEST_CASE(block_malleation)
 {
     // Test utilities that calls `IsBlockMutated` and then clears the validity
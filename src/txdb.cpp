@@ -14,6 +14,7 @@
 #include <uint256.h>
 #include <util/byte_units.h>
 #include <util/log.h>
+#include <util/thread.h>
 #include <util/vector.h>
 
 #include <cassert>
@@ -61,6 +62,7 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
     // We can't do this operation with an in-memory DB since we'll lose all the coins upon
     // reset.
     if (!m_db_params.memory_only) {
+        LOCK(m_db_reset_mutex);
         // Have to do a reset first to get the original `m_db` state to release its
         // filesystem lock.
         m_db.reset();
@@ -70,6 +72,12 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
     }
 }
 
+DBStats CCoinsViewDB::GetDBStats() const
+{
+    LOCK(m_db_reset_mutex);
+    return m_db->GetStats();
+}
+
 std::optional<Coin> CCoinsViewDB::GetCoin(const COutPoint& outpoint) const
 {
     if (Coin coin; m_db->Read(CoinEntry(&outpoint), coin)) {
@@ -175,6 +183,144 @@ size_t CCoinsViewDB::EstimateSize() const
     return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
 }
 
+CoinsViewBackgroundWriter::CoinsViewBackgroundWriter(CCoinsView* view, bool background) : CCoinsViewBacked(view)
+{
+    if (background) {
+        m_thread = std::thread(&util::TraceThread, "coinsflush", [this] { ThreadWrite(); });
+    }
+}
+
+CoinsViewBackgroundWriter::~CoinsViewBackgroundWriter()
+{
+    if (!m_thread.joinable()) return;
+    // The batch being written, if any, is completed first
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+std::shared_ptr<const CoinsViewBackgroundWriter::Batch> CoinsViewBackgroundWriter::GetBatch() const
+{
+    LOCK(m_mutex);
+    return m_batch;
+}
+
+std::optional<Coin> CoinsViewBackgroundWriter::GetCoin(const COutPoint& outpoint) const
+{
+    if (const auto batch{GetBatch()}) {
+        if (const auto it{batch->map.find(outpoint)}; it != batch->map.end()) {
+            return it->second.coin.IsSpent() ? std::nullopt : std::optional{it->second.coin};
+        }
+    }
+    return base->GetCoin(outpoint);
+}
+
+std::optional<Coin> CoinsViewBackgroundWriter::PeekCoin(const COutPoint& outpoint) const
+{
+    if (const auto batch{GetBatch()}) {
+        if (const auto it{batch->map.find(outpoint)}; it != batch->map.end()) {
+            return it->second.coin.IsSpent() ? std::nullopt : std::optional{it->second.coin};
+        }
+    }
+    return base->PeekCoin(outpoint);
+}
+
+bool CoinsViewBackgroundWriter::HaveCoin(const COutPoint& outpoint) const
+{
+    if (const auto batch{GetBatch()}) {
+        if (const auto it{batch->map.find(outpoint)}; it != batch->map.end()) {
+            return !it->second.coin.IsSpent();
+        }
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CoinsViewBackgroundWriter::GetBestBlock() const
+{
+    if (const auto batch{GetBatch()}) return batch->block_hash;
+    return base->GetBestBlock();
+}
+
+std::vector<uint256> CoinsViewBackgroundWriter::GetHeadBlocks() const
+{
+    Wait();
+    return base->GetHeadBlocks();
+}
+
+std::unique_ptr<CCoinsViewCursor> CoinsViewBackgroundWriter::Cursor() const
+{
+    Wait();
+    return base->Cursor();
+}
+
+void CoinsViewBackgroundWriter::Wait() const
+{
+    WAIT_LOCK(m_mutex, lock);
+    m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_writing; });
+}
+
+void CoinsViewBackgroundWriter::ThrowIfFailed() const
+{
+    LOCK(m_mutex);
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+void CoinsViewBackgroundWriter::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash)
+{
+    if (!m_thread.joinable()) return base->BatchWrite(cursor, block_hash);
+    Wait();
+    ThrowIfFailed();
+    auto batch{std::make_shared<Batch>()};
+    {
+        LOG_TIME_MILLIS_WITH_CATEGORY(strprintf("move %d coins to the background write batch", cursor.GetDirtyCount()), BCLog::BENCH);
+        batch->map.reserve(cursor.GetDirtyCount());
+        for (auto it{cursor.Begin()}; it != cursor.End(); it = cursor.NextAndMaybeErase(*it)) {
+            if (!it->second.IsDirty()) continue;
+            // The entries that the caller erases afterwards are moved instead of copied
+            auto [entry, inserted]{batch->map.try_emplace(it->first, cursor.WillErase(*it) ? std::move(it->second.coin) : Coin{it->second.coin})};
+            CCoinsCacheEntry::SetDirty(*entry, batch->sentinel);
+            ++batch->dirty_count;
+        }
+        batch->block_hash = block_hash;
+    }
+    {
+        LOCK(m_mutex);
+        m_batch = std::move(batch);
+        m_writing = true;
+    }
+    m_cv.notify_all();
+}
+
+void CoinsViewBackgroundWriter::ThreadWrite()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_writing || m_stop; });
+        if (!m_writing) return;
+        const std::shared_ptr<Batch> batch{m_batch};
+        std::exception_ptr error;
+        {
+            REVERSE_LOCK(lock, m_mutex);
+            try {
+                // The entries are only read by the base, and the map is not modified when will_erase is set,
+                // so reads of the batch from other threads are safe.
+                CoinsViewCacheCursor cursor{batch->dirty_count, batch->sentinel, batch->map, /*will_erase=*/true};
+                base->BatchWrite(cursor, batch->block_hash);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        if (error) {
+            LogError("Failed to write the coins to the database in the background\n");
+            m_error = error;
+        } else {
+            m_batch.reset();
+        }
+        m_writing = false;
+        m_cv.notify_all();
+    }
+}
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
@@ -13,19 +13,27 @@
 #include <sync.h>
 #include <util/fs.h>
 
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <vector>
 
 class COutPoint;
 class uint256;
 
+//! Whether the coins flushes are written to the database from a background thread by default
+static constexpr bool DEFAULT_COINS_BACKGROUND_FLUSH{false};
+
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
     //! Maximum database write batch size in bytes.
     size_t batch_write_bytes{DEFAULT_DB_CACHE_BATCH};
+    //! Whether to write the coins flushes to the database from a background thread.
+    bool background_flush{DEFAULT_COINS_BACKGROUND_FLUSH};
     //! If non-zero, randomly exit when the database is flushed with (1/ratio) probability.
     int simulate_crash_ratio{0};
 };
@@ -36,6 +44,8 @@ class CCoinsViewDB final : public CCoinsView
 protected:
     DBParams m_db_params;
     CoinsViewOptions m_options;
+    //! Held while m_db is replaced, so that its statistics can be read without cs_main
+    mutable Mutex m_db_reset_mutex;
     std::unique_ptr<CDBWrapper> m_db;
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
@@ -53,7 +63,62 @@ public:
     size_t EstimateSize() const override;
 
     //! Dynamically alter the underlying leveldb cache size.
-    void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main, !m_db_reset_mutex);
+
+    //! Statistics of the database, which does not need cs_main nor a complete flush.
+    DBStats GetDBStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_db_reset_mutex);
+};
+
+/**
+ * CCoinsView between the coins database and the caches above it, which can write their flushes
+ * to the database from a background thread, so they do not stall the validation.
+ *
+ * BatchWrite then moves the flagged entries into an immutable batch and returns, and the caches
+ * are used and refilled while the batch is written. Reads fall through to the batch being written
+ * before the database. Only one batch is written at a time, so BatchWrite first waits for the
+ * previous one. Without the background thread, BatchWrite writes to the database directly.
+ */
+class CoinsViewBackgroundWriter final : public CCoinsViewBacked
+{
+public:
+    CoinsViewBackgroundWriter(CCoinsView* view, bool background);
+    ~CoinsViewBackgroundWriter() override;
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::optional<Coin> PeekCoin(const COutPoint& outpoint) const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool HaveCoin(const COutPoint& outpoint) const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    uint256 GetBestBlock() const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::vector<uint256> GetHeadBlocks() const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::unique_ptr<CCoinsViewCursor> Cursor() const override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Wait until the batch being written, if any, is in the database, or failed to be written.
+    void Wait() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Rethrow the error of a failed background write. Its batch is kept, so reads remain consistent.
+    void ThrowIfFailed() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Batch {
+        CCoinsMapMemoryResource resource;
+        CoinsCachePair sentinel;
+        CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
+        size_t dirty_count{0};
+        uint256 block_hash;
+
+        Batch() { sentinel.second.SelfRef(sentinel); }
+    };
+
+    mutable Mutex m_mutex;
+    mutable std::condition_variable m_cv;
+    //! Batch being written, or which failed to be written
+    std::shared_ptr<Batch> m_batch GUARDED_BY(m_mutex);
+    bool m_writing GUARDED_BY(m_mutex){false};
+    std::exception_ptr m_error GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+
+    std::shared_ptr<const Batch> GetBatch() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void ThreadWrite() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
 };
 
 #endif // BITCOIN_TXDB_H
@@ -0,0 +1,330 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_FLATNODEMAP_H
+#define BITCOIN_UTIL_FLATNODEMAP_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/** Hash map mimicking the subset of std::unordered_map used by the coins cache, with an open addressing table.
+ *
+ * - The table is an array of pointers to the elements, with one control byte per slot holding 7 bits of the
+ *   hash of its key, or whether it is empty or deleted. Lookups first compare a group of 16 control bytes
+ *   at once (with SSE2 if available), and only dereference the slots whose tag matches.
+ * - The elements are allocated one by one from the allocator, so their addresses are stable, as with
+ *   std::unordered_map, and they can be linked together or allocated from a pool.
+ * - The table costs about 10 bytes per element, instead of 3 pointers per element for std::unordered_map
+ *   (bucket, next node, cached hash).
+ * - Iterators are invalidated by insertions that grow the table, erasing an element only invalidates its own.
+ */
+template <typename Key,
+          typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class FlatNodeMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, value_type>);
+
+    static constexpr size_t GROUP_SIZE{16};
+    //! Control bytes of slots without element, full ones hold the 7 low bits of the hash of their key
+    static constexpr int8_t EMPTY{-128};
+    static constexpr int8_t DELETED{-2};
+
+    struct alignas(GROUP_SIZE) Group {
+        int8_t ctrl[GROUP_SIZE];
+
+#if defined(__SSE2__)
+        uint32_t Match(int8_t tag) const noexcept
+        {
+            const __m128i ctrl_bytes{_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))};
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_bytes, _mm_set1_epi8(tag))));
+        }
+        //! Empty and deleted slots are the ones with the sign bit set
+        uint32_t MatchNonFull() const noexcept
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))));
+        }
+#else
+        uint32_t Match(int8_t tag) const noexcept
+        {
+            uint32_t mask{0};
+            for (size_t i{0}; i < GROUP_SIZE; ++i) mask |= uint32_t{ctrl[i] == tag} << i;
+            return mask;
+        }
+        uint32_t MatchNonFull() const noexcept
+        {
+            uint32_t mask{0};
+            for (size_t i{0}; i < GROUP_SIZE; ++i) mask |= uint32_t{ctrl[i] < 0} << i;
+            return mask;
+        }
+#endif
+    };
+
+    Hash m_hash;
+    KeyEqual m_equal;
+    Allocator m_alloc;
+    std::unique_ptr<Group[]> m_groups;
+    std::unique_ptr<value_type*[]> m_slots;
+    //! Number of groups, a power of 2 or 0
+    size_t m_num_groups{0};
+    size_t m_size{0};
+    //! Number of empty slots that can still be filled before the table must be rehashed
+    size_t m_growth_left{0};
+
+    static constexpr size_t NPOS{~size_t{0}};
+
+    //! At most 7/8 of the slots can be filled (or deleted), so probe sequences always end at an empty slot
+    static constexpr size_t MaxLoad(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+    int8_t& Ctrl(size_t index) const noexcept { return m_groups[index / GROUP_SIZE].ctrl[index % GROUP_SIZE]; }
+
+    //! The probe sequences start at the group given by the high bits of the hash, and their triangular steps visit all the groups
+    size_t FirstGroup(size_t hash) const noexcept { return (hash >> 7) & (m_num_groups - 1); }
+    size_t NextGroup(size_t group, size_t step) const noexcept { return (group + step) & (m_num_groups - 1); }
+
+    size_t FindIndex(const Key& key, size_t hash) const
+    {
+        if (m_num_groups == 0) return NPOS;
+        const int8_t tag{static_cast<int8_t>(hash & 0x7F)};
+        for (size_t group{FirstGroup(hash)}, step{1};; group = NextGroup(group, step++)) {
+            for (uint32_t match{m_groups[group].Match(tag)}; match != 0; match &= match - 1) {
+                const size_t index{group * GROUP_SIZE + std::countr_zero(match)};
+                if (m_equal(m_slots[index]->first, key)) return index;
+            }
+            // An empty slot ends the probe sequence, as an insertion would have used it
+            if (m_groups[group].Match(EMPTY) != 0) return NPOS;
+        }
+    }
+
+    size_t FindInsertIndex(size_t hash) const noexcept
+    {
+        for (size_t group{FirstGroup(hash)}, step{1};; group = NextGroup(group, step++)) {
+            if (const uint32_t non_full{m_groups[group].MatchNonFull()}; non_full != 0) {
+                return group * GROUP_SIZE + std::countr_zero(non_full);
+            }
+        }
+    }
+
+    size_t NextFull(size_t index) const noexcept
+    {
+        const size_t capacity{bucket_count()};
+        while (index < capacity && Ctrl(index) < 0) ++index;
+        return index;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        auto groups{std::make_unique_for_overwrite<Group[]>(capacity / GROUP_SIZE)};
+        std::memset(groups.get(), static_cast<uint8_t>(EMPTY), capacity);
+        auto slots{std::make_unique_for_overwrite<value_type*[]>(capacity)};
+        std::swap(groups, m_groups);
+        std::swap(slots, m_slots);
+        const size_t old_capacity{m_num_groups * GROUP_SIZE};
+        m_num_groups = capacity / GROUP_SIZE;
+        for (size_t old_index{0}; old_index < old_capacity; ++old_index) {
+            if (groups[old_index / GROUP_SIZE].ctrl[old_index % GROUP_SIZE] < 0) continue;
+            const size_t hash{m_hash(slots[old_index]->first)};
+            const size_t index{FindInsertIndex(hash)};
+            Ctrl(index) = static_cast<int8_t>(hash & 0x7F);
+            m_slots[index] = slots[old_index];
+        }
+        m_growth_left = MaxLoad(capacity) - m_size;
+    }
+
+    //! Make room for one more element, dropping the deleted slots, and doubling the capacity unless they were many
+    void Grow()
+    {
+        const size_t capacity{bucket_count()};
+        Rehash(capacity == 0 ? GROUP_SIZE : (m_size + 1 > capacity * 7 / 16 ? capacity * 2 : capacity));
+    }
+
+    void DestroyNode(value_type* node) noexcept
+    {
+        AllocTraits::destroy(m_alloc, node);
+        AllocTraits::deallocate(m_alloc, node, 1);
+    }
+
+    template <bool CONST>
+    class Iterator
+    {
+        friend class FlatNodeMap;
+        template <bool>
+        friend class Iterator;
+        using Map = std::conditional_t<CONST, const FlatNodeMap, FlatNodeMap>;
+
+        Map* m_map{nullptr};
+        size_t m_index{0};
+
+        Iterator(Map* map, size_t index) noexcept : m_map{map}, m_index{index} {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatNodeMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<CONST, const value_type*, value_type*>;
+        using reference = std::conditional_t<CONST, const value_type&, value_type&>;
+
+        Iterator() noexcept = default;
+        template <bool OTHER_CONST>
+            requires(CONST && !OTHER_CONST)
+        Iterator(const Iterator<OTHER_CONST>& other) noexcept : m_map{other.m_map}, m_index{other.m_index} {}
+
+        reference operator*() const noexcept { return *m_map->m_slots[m_index]; }
+        pointer operator->() const noexcept { return m_map->m_slots[m_index]; }
+        Iterator& operator++() noexcept
+        {
+            m_index = m_map->NextFull(m_index + 1);
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator copy{*this};
+            ++*this;
+            return copy;
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.m_index == b.m_index && a.m_map == b.m_map; }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit FlatNodeMap(size_t bucket_count = 0, const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{}, const Allocator& alloc = Allocator{})
+        : m_hash{hash}, m_equal{equal}, m_alloc{alloc}
+    {
+        reserve(bucket_count);
+    }
+
+    FlatNodeMap(const FlatNodeMap&) = delete;
+    FlatNodeMap& operator=(const FlatNodeMap&) = delete;
+
+    ~FlatNodeMap() { clear(); }
+
+    iterator begin() noexcept { return {this, NextFull(0)}; }
+    const_iterator begin() const noexcept { return {this, NextFull(0)}; }
+    iterator end() noexcept { return {this, bucket_count()}; }
+    const_iterator end() const noexcept { return {this, bucket_count()}; }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    //! Number of slots of the table
+    size_t bucket_count() const noexcept { return m_num_groups * GROUP_SIZE; }
+    allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    iterator find(const Key& key)
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        return {this, index == NPOS ? bucket_count() : index};
+    }
+    const_iterator find(const Key& key) const
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        return {this, index == NPOS ? bucket_count() : index};
+    }
+    bool contains(const Key& key) const { return FindIndex(key, m_hash(key)) != NPOS; }
+    size_t count(const Key& key) const { return contains(key); }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        const size_t hash{m_hash(key)};
+        if (const size_t index{FindIndex(key, hash)}; index != NPOS) return {iterator{this, index}, false};
+        if (m_num_groups == 0) Grow();
+        size_t index{FindInsertIndex(hash)};
+        if (m_growth_left == 0 && Ctrl(index) == EMPTY) {
+            Grow();
+            index = FindInsertIndex(hash);
+        }
+        // The table is only modified once the element is constructed, in case it throws
+        value_type* node{AllocTraits::allocate(m_alloc, 1)};
+        try {
+            AllocTraits::construct(m_alloc, node, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            AllocTraits::deallocate(m_alloc, node, 1);
+            throw;
+        }
+        if (Ctrl(index) == EMPTY) --m_growth_left;
+        Ctrl(index) = static_cast<int8_t>(hash & 0x7F);
+        m_slots[index] = node;
+        ++m_size;
+        return {iterator{this, index}, true};
+    }
+
+    //! Unlike std::unordered_map::emplace, the mapped value is not constructed if the key is already present
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) { return try_emplace(std::forward<K>(key), std::forward<V>(value)); }
+
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        const size_t index{pos.m_index};
+        DestroyNode(m_slots[index]);
+        // A group with an empty slot never made a probe sequence go further, so the slot can be emptied
+        if (m_groups[index / GROUP_SIZE].Match(EMPTY) != 0) {
+            Ctrl(index) = EMPTY;
+            ++m_growth_left;
+        } else {
+            Ctrl(index) = DELETED;
+        }
+        --m_size;
+        return {this, NextFull(index + 1)};
+    }
+
+    size_t erase(const Key& key)
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        if (index == NPOS) return 0;
+        erase(const_iterator{this, index});
+        return 1;
+    }
+
+    //! Destroy all elements, keeping the table allocated
+    void clear() noexcept
+    {
+        if (m_num_groups == 0) return;
+        for (size_t index{m_size > 0 ? NextFull(0) : bucket_count()}; index < bucket_count(); index = NextFull(index + 1)) {
+            DestroyNode(m_slots[index]);
+        }
+        std::memset(m_groups.get(), static_cast<uint8_t>(EMPTY), bucket_count());
+        m_size = 0;
+        m_growth_left = MaxLoad(bucket_count());
+    }
+
+    //! Allocate the table for at least count elements
+    void reserve(size_t count)
+    {
+        if (count == 0) return;
+        size_t capacity{GROUP_SIZE};
+        while (MaxLoad(capacity) < count) capacity *= 2;
+        if (capacity > bucket_count()) Rehash(capacity);
+    }
+};
+
+#endif // BITCOIN_UTIL_FLATNODEMAP_H
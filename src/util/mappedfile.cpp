@@ -0,0 +1,54 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/mappedfile.h>
+
+#include <algorithm>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<MappedFile> MappedFile::Open(const fs::path& path)
+{
+#ifdef WIN32
+    return nullptr;
+#else
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd == -1)
+        return nullptr;
+    struct stat st;
+    void* data{MAP_FAILED};
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid once the descriptor is closed
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+    return std::unique_ptr<MappedFile>{new MappedFile{{static_cast<const std::byte*>(data), static_cast<size_t>(st.st_size)}}};
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef WIN32
+    munmap(const_cast<std::byte*>(m_data.data()), m_data.size());
+#endif
+}
+
+void MappedFile::WillNeed(size_t offset, size_t size) const
+{
+#ifndef WIN32
+    if (offset >= m_data.size())
+        return;
+    // madvise requires a page aligned address
+    const size_t page_size{static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+    const size_t begin{offset - offset % page_size};
+    const size_t end{std::min(offset + size, m_data.size())};
+    madvise(const_cast<std::byte*>(m_data.data()) + begin, end - begin, MADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2013-present The Riecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_MAPPEDFILE_H
+#define BITCOIN_UTIL_MAPPEDFILE_H
+
+#include <util/fs.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+/**
+ * Read-only memory mapping of a whole file, unmapped on destruction.
+ *
+ * The mapping is shared, so later writes to the file through other handles are visible within
+ * the mapped size. The caller must not access the parts of the mapping beyond the end of the
+ * file if it is truncated. Mappings are not supported on Windows, where they would prevent the
+ * file from being truncated or deleted.
+ */
+class MappedFile
+{
+public:
+#ifdef WIN32
+    static constexpr bool SUPPORTED{false};
+#else
+    static constexpr bool SUPPORTED{true};
+#endif
+
+    /** Map the file at path, nullptr if it is empty or could not be mapped. */
+    static std::unique_ptr<MappedFile> Open(const fs::path& path);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> Data() const { return m_data; }
+
+    /** Advise the OS that the given range will be read soon, so it reads it ahead. */
+    void WillNeed(size_t offset, size_t size) const;
+
+private:
+    explicit MappedFile(std::span<const std::byte> data) : m_data{data} {}
+
+    std::span<const std::byte> m_data;
+};
+
+#endif // BITCOIN_UTIL_MAPPEDFILE_H
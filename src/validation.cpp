@@ -30,7 +30,7 @@
 #include <kernel/types.h>
 #include <kernel/warning.h>
 #include <logging/timer.h>
-#include <net_processing.h> // For MAX_HEADERS_RESULTS
+#include <node/blockprefetcher.h>
 #include <node/blockstorage.h>
 #include <node/utxo_snapshot.h>
 #include <policy/ephemeral_policy.h>
@@ -76,6 +76,7 @@
 #include <span>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 
 using kernel::CCoinsStats;
@@ -1862,8 +1863,9 @@ CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 }
 
 CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
-    : m_dbview{std::move(db_params), std::move(options)},
-      m_catcherview(&m_dbview) {}
+    : m_dbview{std::move(db_params), options},
+      m_writerview{&m_dbview, options.background_flush},
+      m_catcherview(&m_writerview) {}
 
 void CoinsViews::InitCache()
 {
@@ -2315,7 +2317,8 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // is enforced in ContextualCheckBlockHeader(); we wouldn't want to
     // re-enforce that rule here (at least until we make it impossible for
     // the clock to go backward).
-    if (!CheckBlock(block, state, params.GetConsensus(), !fJustCheck && fScriptPoWChecks, !fJustCheck)) {
+    // The PoW is not checked again, the Block Index only contains Headers whose PoW was verified when they were accepted.
+    if (!CheckBlock(block, state, params.GetConsensus(), /*fCheckPOW=*/false, !fJustCheck)) {
         if (state.GetResult() == BlockValidationResult::BLOCK_MUTATED) {
             // We don't write down blocks to disk if they may have been
             // corrupted, so this should be impossible unless we're having hardware
@@ -2603,6 +2606,8 @@ bool Chainstate::FlushStateToDisk(
 
     try {
     {
+        // A failed background write of the coins is reported by the next call
+        CoinsWriter().ThrowIfFailed();
         bool fFlushForPrune = false;
 
         CoinsCacheSizeState cache_state = GetCoinsCacheSizeState();
@@ -2688,6 +2693,8 @@ bool Chainstate::FlushStateToDisk(
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
+                // A coins flush still written in the background may need the blocks of the pruned files to be replayed
+                CoinsWriter().Wait();
                 m_blockman.UnlinkPrunedFiles(setFilesToPrune);
             }
 
@@ -2702,6 +2709,11 @@ bool Chainstate::FlushStateToDisk(
                 }
                 // Flush the chainstate (which may refer to block index entries).
                 empty_cache ? CoinsTip().Flush() : CoinsTip().Sync();
+                // Only the flushes for the cache size or the periodic ones are left to be written in the background
+                if (mode == FlushStateMode::FORCE_FLUSH || mode == FlushStateMode::FORCE_SYNC || fFlushForPrune) {
+                    CoinsWriter().Wait();
+                    CoinsWriter().ThrowIfFailed();
+                }
                 full_flush_completed = true;
                 TRACEPOINT(utxocache, flush,
                     int64_t{Ticks<std::chrono::microseconds>(NodeClock::now() - nNow)},
@@ -2885,6 +2897,35 @@ struct ConnectedBlock {
     std::shared_ptr<const CBlock> pblock;
 };
 
+void Chainstate::PrefetchCoins(const CBlock& block, CoinsViewOverlay& view)
+{
+    AssertLockHeld(cs_main);
+    CCheckQueue<CCoinPrefetch>& queue{m_chainman.m_coin_prefetch_queue};
+    // Without worker threads, the reads would only be done earlier, not faster
+    if (!queue.HasThreads() || block.vtx.size() < 2) return;
+    const auto time_start{SteadyClock::now()};
+    std::unordered_set<Txid, SaltedTxidHasher> block_txids;
+    block_txids.reserve(block.vtx.size());
+    for (const auto& tx : block.vtx) block_txids.insert(tx->GetHash());
+    std::vector<std::pair<COutPoint, std::optional<Coin>>> coins;
+    for (const auto& tx : block.vtx | std::views::drop(1)) {
+        for (const CTxIn& txin : tx->vin) {
+            // A spent but unflushed entry in the tip must win over the coin still in the database
+            if (!block_txids.contains(txin.prevout.hash) && !CoinsTip().HaveEntryInCache(txin.prevout))
+                coins.emplace_back(txin.prevout, std::nullopt);
+        }
+    }
+    if (coins.empty()) return;
+    std::vector<CCoinPrefetch> reads;
+    reads.reserve(coins.size());
+    for (auto& [outpoint, coin] : coins) reads.emplace_back(CoinsErrorCatcher(), outpoint, coin);
+    CCheckQueueControl<CCoinPrefetch> control(queue);
+    control.Add(std::move(reads));
+    control.Complete();
+    LogDebug(BCLog::BENCH, "  - Prefetch %u coins: %.2fms\n", coins.size(), Ticks<MillisecondsDouble>(SteadyClock::now() - time_start));
+    view.SetPrefetchedCoins(std::move(coins));
+}
+
 /**
  * Connect a new block to m_chain. block_to_connect is either nullptr or a pointer to a CBlock
  * corresponding to pindexNew, to bypass loading it again from disk.
@@ -2921,8 +2962,9 @@ bool Chainstate::ConnectTip(
     LogDebug(BCLog::BENCH, "  - Load block from disk: %.2fms\n",
              Ticks<MillisecondsDouble>(time_2 - time_1));
     {
-        CCoinsViewCache& view{*m_coins_views->m_connect_block_view};
+        CoinsViewOverlay& view{*m_coins_views->m_connect_block_view};
         const auto reset_guard{view.CreateResetGuard()};
+        PrefetchCoins(*block_to_connect, view);
         bool rv = ConnectBlock(*block_to_connect, state, pindexNew, view);
         if (m_chainman.m_options.signals) {
             m_chainman.m_options.signals->BlockChecked(block_to_connect, state);
@@ -3717,6 +3759,18 @@ static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& st
     return true;
 }
 
+CPoWCheck::CPoWCheck(const CBlockHeader& header, const Consensus::Params& params, uint8_t& verified) :
+    m_header(&header), m_params(&params), m_verified(&verified) { }
+
+std::optional<uint256> CPoWCheck::operator()()
+{
+    const PoWCostScope powCostScope(nullptr);
+    if (!CheckProofOfWork(m_header->GetHashForPoW(), m_header->nBits, ArithToUint256(m_header->nNonce), *m_params))
+        return m_header->GetHash();
+    *m_verified = 1;
+    return std::nullopt;
+}
+
 static bool CheckMerkleRoot(const CBlock& block, BlockValidationState& state)
 {
     if (block.m_checked_merkle_root) return true;
@@ -4111,17 +4165,53 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
 bool ChainstateManager::ProcessNewBlockHeaders(std::span<const CBlockHeader> headers, BlockValidationState& state, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
+    // PoW Check in Riecoin is quite expensive and makes Initial Sync very long, recognize existing Batches of Headers and don't check the PoW for them.
+    // The Headers do not need to be aligned with the Batches: the beginning of the first Batch is taken from the Block Index, so resumed Syncs are recognized too.
+    size_t knownHeaders(0);
+    std::vector<size_t> newHeaders; // Headers not in the Block Index yet, AcceptBlockHeader returns early for the others
     {
         LOCK(cs_main);
-        // PoW Check in Riecoin is quite expensive and makes Initial Sync very long, recognize existing Batches of Headers and don't check the PoW for them.
-        bool knownHeaderBatch(false);
-        if (headers.size() == MAX_HEADERS_RESULTS) {
-            if (GetParams().Checkpoints().isKnownHeaderBatch(headers, m_best_header->nHeight + 1))
-                knownHeaderBatch = true;
+        const CBlockIndex* pindexPrev(headers.empty() ? nullptr : m_blockman.LookupBlockIndex(headers[0].hashPrevBlock));
+        if (pindexPrev) {
+            const uint32_t start(pindexPrev->nHeight + 1);
+            if (const auto batchStart{GetParams().Checkpoints().getHeaderBatchStart(start)}) {
+                std::vector<CBlockHeader> previousHeaders(start - *batchStart);
+                for (auto it(previousHeaders.rbegin()) ; it != previousHeaders.rend() ; it++) {
+                    *it = pindexPrev->GetBlockHeader();
+                    pindexPrev = pindexPrev->pprev;
+                }
+                knownHeaders = GetParams().Checkpoints().countKnownHeaders(previousHeaders, headers, start);
+            }
         }
-        for (const CBlockHeader& header : headers) {
+        // The PoW Check of a Header with an absurd Difficulty can be extremely expensive, so only check in advance the ones with a plausible nBits.
+        // The others are only checked by AcceptBlockHeader once ContextualCheckBlockHeader verified their nBits.
+        const uint64_t maxNBits(static_cast<uint64_t>(m_best_header->nBits) + MAX_HEADERS_PREVALIDATION_NBITS_INCREASE);
+        for (size_t i(knownHeaders) ; i < headers.size() ; i++) {
+            if (headers[i].nBits <= maxNBits && !m_blockman.LookupBlockIndex(headers[i].GetHash()))
+                newHeaders.push_back(i);
+        }
+    }
+    // Otherwise, check the PoW of all the new Headers in parallel without holding cs_main, so only the cheap Contextual Checks and the Block Index insertion are done under the lock.
+    // If a Header fails, the remaining checks are skipped and the unverified Headers are checked again by AcceptBlockHeader, which also sets the appropriate State.
+    std::vector<uint8_t> powVerified(headers.size(), 0);
+    if (!newHeaders.empty()) {
+        std::vector<CPoWCheck> checks;
+        checks.reserve(newHeaders.size());
+        for (const size_t i : newHeaders)
+            checks.emplace_back(headers[i], GetConsensus(), powVerified[i]);
+        const auto time_start{SteadyClock::now()};
+        CCheckQueueControl<CPoWCheck> control(m_pow_check_queue);
+        control.Add(std::move(checks));
+        if (const auto invalidHeader{control.Complete()})
+            LogDebug(BCLog::VALIDATION, "%s: invalid PoW for header %s\n", __func__, invalidHeader->ToString());
+        PoWCostScope::Account(std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - time_start));
+    }
+    {
+        LOCK(cs_main);
+        for (size_t i(0) ; i < headers.size() ; i++) {
+            const CBlockHeader& header(headers[i]);
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            bool accepted{AcceptBlockHeader(header, state, &pindex, !knownHeaderBatch)};
+            bool accepted{AcceptBlockHeader(header, state, &pindex, i >= knownHeaders && !powVerified[i])};
             CheckBlockIndex();
 
             if (!accepted) {
@@ -4155,7 +4245,7 @@ bool ChainstateManager::AcceptBlock(const std::shared_ptr<const CBlock>& pblock,
     CBlockIndex *pindexDummy = nullptr;
     CBlockIndex *&pindex = ppindex ? *ppindex : pindexDummy;
 
-    bool accepted_header{AcceptBlockHeader(block, state, &pindex)};
+    bool accepted_header{AcceptBlockHeader(block, state, &pindex, /*checkPoW=*/!block.fChecked)}; // The PoW was already checked if CheckBlock() fully succeeded
     CheckBlockIndex();
 
     if (!accepted_header)
@@ -4195,22 +4285,11 @@ bool ChainstateManager::AcceptBlock(const std::shared_ptr<const CBlock>& pblock,
         if (pindex->nChainWork < MinimumChainWork()) return true;
     }
 
-    // Bypass PoW Check if Ancestor of Assumed Valid Block.
-    bool fPoWChecks = true;
-    if (!AssumedValidBlock().IsNull()) {
-        BlockMap::const_iterator it{m_blockman.m_block_index.find(AssumedValidBlock())};
-        if (it != m_blockman.m_block_index.end()) {
-            if (it->second.GetAncestor(pindex->nHeight) == pindex &&
-                m_best_header->GetAncestor(pindex->nHeight) == pindex &&
-                m_best_header->nChainWork >= MinimumChainWork())
-                fPoWChecks = false;
-        }
-    }
-
     const CChainParams& params{GetParams()};
 
+    // The Header is in the Block Index now, so its PoW was verified, by AcceptBlockHeader or when it was accepted earlier
     if (!ContextualCheckBlock(block, state, *this, pindex->pprev) ||
-        !CheckBlock(block, state, params.GetConsensus(), fPoWChecks)) {
+        !CheckBlock(block, state, params.GetConsensus(), /*fCheckPOW=*/false)) {
         if (Assume(state.IsInvalid())) {
             ActiveChainstate().InvalidBlockFound(pindex, state);
         }
@@ -4270,23 +4349,9 @@ bool ChainstateManager::ProcessNewBlock(const std::shared_ptr<const CBlock>& blo
         // Therefore, the following critical section must include the CheckBlock() call as well.
         LOCK(cs_main);
 
-        // Bypass PoW Check if Ancestor of Assumed Valid Block.
-        bool fPoWChecks = true;
-        if (!AssumedValidBlock().IsNull()) {
-            uint256 hash = block->GetHash();
-            BlockMap::iterator miSelf{m_blockman.m_block_index.find(hash)};
-            CBlockIndex* pindexTmp = nullptr;
-            if (hash != GetConsensus().hashGenesisBlock)
-                if (miSelf != m_blockman.m_block_index.end())
-                    pindexTmp = &(miSelf->second);
-            BlockMap::const_iterator it{m_blockman.m_block_index.find(AssumedValidBlock())};
-            if (pindexTmp && it != m_blockman.m_block_index.end()) {
-                if (it->second.GetAncestor(pindexTmp->nHeight) == pindexTmp &&
-                    m_best_header->GetAncestor(pindexTmp->nHeight) == pindexTmp &&
-                    m_best_header->nChainWork >= MinimumChainWork())
-                    fPoWChecks = false;
-            }
-        }
+        // Bypass the PoW Check if the Header is already in the Block Index: it was verified when the Header was accepted (or is part of a hardcoded Header Batch), and the Block Hash commits to all the PoW data.
+        // This notably avoids checking the PoW again for Blocks received after their Headers, including reconstructed Compact Blocks.
+        const bool fPoWChecks{m_blockman.LookupBlockIndex(block->GetHash()) == nullptr};
 
         // Skipping AcceptBlock() for CheckBlock() failures means that we will never mark a block as invalid if
         // CheckBlock() fails.  This is protective against consensus failure if there are any unknown forms of block
@@ -4519,6 +4584,13 @@ VerifyDBResult CVerifyDB::VerifyDB(
 
     const bool is_snapshot_cs{chainstate.m_from_snapshot_blockhash};
 
+    // The blocks are read ahead along the walk down to the check depth, then back up to the tip at level 4
+    node::BlockPrefetcher prefetcher{chainstate.m_blockman};
+    const auto previous_block{[&](const CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) -> const CBlockIndex* {
+        return block.pprev && block.pprev->pprev && block.pprev->nHeight > chainstate.m_chain.Height() - nCheckDepth ? block.pprev : nullptr;
+    }};
+    const auto next_block{[&](const CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) { return chainstate.m_chain.Next(block); }};
+
     for (pindex = chainstate.m_chain.Tip(); pindex && pindex->pprev; pindex = pindex->pprev) {
         const int percentageDone = std::max(1, std::min(99, (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * (nCheckLevel >= 4 ? 50 : 100))));
         if (reportDone < percentageDone / 10) {
@@ -4537,12 +4609,13 @@ VerifyDBResult CVerifyDB::VerifyDB(
             skipped_no_block_data = true;
             break;
         }
-        CBlock block;
         // check level 0: read from disk
-        if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+        const std::shared_ptr<const CBlock> read_block{prefetcher.Read(*pindex, previous_block)};
+        if (!read_block) {
             LogError("Verification error: ReadBlock failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
             return VerifyDBResult::CORRUPTED_BLOCK_DB;
         }
+        const CBlock& block{*read_block};
         // check level 1: verify block validity
         if (nCheckLevel >= 1 && !CheckBlock(block, state, consensus_params)) {
             LogError("Verification error: found bad block at %d, hash=%s (%s)",
@@ -4604,12 +4677,12 @@ VerifyDBResult CVerifyDB::VerifyDB(
             }
             m_notifications.progress(_("Verifying blocks…"), percentageDone, false);
             pindex = chainstate.m_chain.Next(*pindex);
-            CBlock block;
-            if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+            const std::shared_ptr<const CBlock> block{prefetcher.Read(*pindex, next_block)};
+            if (!block) {
                 LogError("Verification error: ReadBlock failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
                 return VerifyDBResult::CORRUPTED_BLOCK_DB;
             }
-            if (!chainstate.ConnectBlock(block, state, pindex, coins)) {
+            if (!chainstate.ConnectBlock(*block, state, pindex, coins)) {
                 LogError("Verification error: found unconnectable block at %d, hash=%s (%s)", pindex->nHeight, pindex->GetBlockHash().ToString(), state.ToString());
                 return VerifyDBResult::CORRUPTED_BLOCK_DB;
             }
@@ -4970,7 +5043,8 @@ void ChainstateManager::LoadExternalBlockFile(
                     while (range.first != range.second) {
                         std::multimap<uint256, FlatFilePos>::iterator it = range.first;
                         std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (m_blockman.ReadBlock(*pblockrecursive, it->second, {})) {
+                        // AcceptBlock checks the PoW, so ReadBlock does not need to
+                        if (m_blockman.ReadBlock(*pblockrecursive, it->second, {}, /*check_pow=*/false)) {
                             const auto& block_hash{pblockrecursive->GetHash()};
                             LogDebug(BCLog::REINDEX, "%s: Processing out of order child %s of %s", __func__, block_hash.ToString(), head.ToString());
                             LOCK(cs_main);
@@ -6016,6 +6090,8 @@ static ChainstateManager::Options&& Flatten(ChainstateManager::Options&& opts)
 
 ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Options options, node::BlockManager::Options blockman_options)
     : m_script_check_queue{/*batch_size=*/128, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)},
+      m_pow_check_queue{/*batch_size=*/4, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS), "PoW", "powch"},
+      m_coin_prefetch_queue{/*batch_size=*/16, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS), "CoinPrefetch", "coinpf"},
       m_interrupt{interrupt},
       m_options{Flatten(std::move(options))},
       m_blockman{interrupt, std::move(blockman_options)},
@@ -89,6 +89,9 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES{550_MiB};
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
 
+/** Maximum nBits increase relative to the best Header for a Header to have its PoW checked before its Contextual Checks (64 bits of Difficulty) */
+static constexpr uint32_t MAX_HEADERS_PREVALIDATION_NBITS_INCREASE{64*256};
+
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
     INIT_REINDEX,
@@ -363,6 +366,64 @@ static_assert(std::is_nothrow_move_assignable_v<CScriptCheck>);
 static_assert(std::is_nothrow_move_constructible_v<CScriptCheck>);
 static_assert(std::is_nothrow_destructible_v<CScriptCheck>);
 
+/**
+ * Closure representing the PoW check of a single Block Header, allowing batches of Headers to be verified in parallel without cs_main.
+ * On success, the corresponding verified flag is set (each check owns a distinct flag, so no synchronization is needed until the queue completes).
+ * On failure, the Hash of the Header is returned.
+ * The time spent by each check is not accounted to any PoWCostScope: the thread waiting for the batch accounts its wall-clock time,
+ * since the sum of the time spent by all the threads verifying it does not reflect how long the others waited.
+ */
+class CPoWCheck
+{
+private:
+    const CBlockHeader* m_header;
+    const Consensus::Params* m_params;
+    uint8_t* m_verified;
+
+public:
+    CPoWCheck(const CBlockHeader& header, const Consensus::Params& params, uint8_t& verified);
+
+    CPoWCheck(const CPoWCheck&) = delete;
+    CPoWCheck& operator=(const CPoWCheck&) = delete;
+    CPoWCheck(CPoWCheck&&) = default;
+    CPoWCheck& operator=(CPoWCheck&&) = default;
+
+    std::optional<uint256> operator()();
+};
+
+static_assert(std::is_nothrow_move_assignable_v<CPoWCheck>);
+static_assert(std::is_nothrow_move_constructible_v<CPoWCheck>);
+
+/**
+ * Closure reading a Coin spent by a Block from the coins database ahead of ConnectBlock, allowing these reads to be done in parallel.
+ * Each read fills its own result slot, and never fails (read errors are handled by the view).
+ */
+class CCoinPrefetch
+{
+private:
+    const CCoinsView* m_view;
+    const COutPoint* m_outpoint;
+    std::optional<Coin>* m_coin;
+
+public:
+    CCoinPrefetch(const CCoinsView& view, const COutPoint& outpoint, std::optional<Coin>& coin) :
+        m_view(&view), m_outpoint(&outpoint), m_coin(&coin) { }
+
+    CCoinPrefetch(const CCoinPrefetch&) = delete;
+    CCoinPrefetch& operator=(const CCoinPrefetch&) = delete;
+    CCoinPrefetch(CCoinPrefetch&&) = default;
+    CCoinPrefetch& operator=(CCoinPrefetch&&) = default;
+
+    std::optional<COutPoint> operator()()
+    {
+        *m_coin = m_view->PeekCoin(*m_outpoint);
+        return std::nullopt;
+    }
+};
+
+static_assert(std::is_nothrow_move_assignable_v<CCoinPrefetch>);
+static_assert(std::is_nothrow_move_constructible_v<CCoinPrefetch>);
+
 /**
  * Convenience class for initializing and passing the script execution cache
  * and signature cache.
@@ -477,6 +538,9 @@ public:
     //! All unspent coins reside in this store.
     CCoinsViewDB m_dbview GUARDED_BY(cs_main);
 
+    //! This view writes the flushes to m_dbview, from a background thread if enabled.
+    CoinsViewBackgroundWriter m_writerview GUARDED_BY(cs_main);
+
     //! This view wraps access to the leveldb instance and handles read errors gracefully.
     CCoinsViewErrorCatcher m_catcherview GUARDED_BY(cs_main);
 
@@ -685,7 +749,17 @@ public:
     }
 
     //! @returns A reference to the on-disk UTXO set database.
+    //! Any flush still being written in the background is waited for, so it is complete.
     CCoinsViewDB& CoinsDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        Assert(m_coins_views)->m_writerview.Wait();
+        return m_coins_views->m_dbview;
+    }
+
+    //! @returns A reference to the on-disk UTXO set database, without waiting for a flush being
+    //! written in the background, so only for what does not need a flushed state, like its statistics.
+    CCoinsViewDB& CoinsDBUnflushed() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
     {
         AssertLockHeld(::cs_main);
         return Assert(m_coins_views)->m_dbview;
@@ -705,6 +779,13 @@ public:
         return Assert(m_coins_views)->m_catcherview;
     }
 
+    //! @returns A reference to the view writing the flushes of the UTXO set to the database.
+    CoinsViewBackgroundWriter& CoinsWriter() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        return Assert(m_coins_views)->m_writerview;
+    }
+
     //! Destructs all objects related to accessing the UTXO set.
     void ResetCoinsViews() { m_coins_views.reset(); }
 
@@ -853,6 +934,12 @@ protected:
         std::vector<ConnectedBlock>& connected_blocks,
         DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
 
+    /**
+     * Read in parallel the Coins spent by block that are not in the coins cache, and are not created by the block
+     * itself, from the coins database into view, so ConnectBlock does not wait for these reads one by one.
+     */
+    void PrefetchCoins(const CBlock& block, CoinsViewOverlay& view) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     void InvalidBlockFound(CBlockIndex* pindex, const BlockValidationState& state) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -964,6 +1051,10 @@ private:
 
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
+    //! A queue for the PoW verifications of Header batches, performed by worker threads outside cs_main.
+    CCheckQueue<CPoWCheck> m_pow_check_queue;
+    //! A queue for the reads of the Coins spent by a Block from the coins database, ahead of ConnectBlock.
+    CCheckQueue<CCoinPrefetch> m_coin_prefetch_queue;
 
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
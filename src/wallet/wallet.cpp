@@ -1874,6 +1874,9 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 
     std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
     if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
+    // Without block filters, every block is read in order, so the following ones are read ahead
+    std::unique_ptr<interfaces::BlockReader> block_reader;
+    if (!fast_rescan_filter) block_reader = chain().makeBlockReader();
 
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
@@ -1929,14 +1932,21 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 
         if (fetch_block) {
             // Read block data and locator if needed (the locator is usually null unless we need to save progress)
-            CBlock block;
+            std::shared_ptr<const CBlock> block;
             CBlockLocator loc;
-            // Find block
-            FoundBlock found_block{FoundBlock().data(block)};
-            if (save_progress && next_interval) found_block.locator(loc);
-            chain().findBlock(block_hash, found_block);
+            if (block_reader) {
+                block = block_reader->readBlock(block_hash);
+                if (save_progress && next_interval) chain().findBlock(block_hash, FoundBlock().locator(loc));
+            } else {
+                // Find block
+                CBlock found_data;
+                FoundBlock found_block{FoundBlock().data(found_data)};
+                if (save_progress && next_interval) found_block.locator(loc);
+                chain().findBlock(block_hash, found_block);
+                if (!found_data.IsNull()) block = std::make_shared<const CBlock>(std::move(found_data));
+            }
 
-            if (!block.IsNull()) {
+            if (block) {
                 LOCK(cs_wallet);
                 if (!block_still_active) {
                     // Abort scan if current block is no longer active, to prevent
@@ -1945,8 +1955,8 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     result.status = ScanResult::FAILURE;
                     break;
                 }
-                for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, /*rescanning_old_block=*/true);
+                for (size_t posInBlock = 0; posInBlock < block->vtx.size(); ++posInBlock) {
+                    SyncTransaction(block->vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, /*rescanning_old_block=*/true);
                 }
                 // scan succeeded, record block as most recent successfully scanned
                 result.last_scanned_block = block_hash;
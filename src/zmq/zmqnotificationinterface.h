@@ -17,6 +17,12 @@
 
 class CBlockIndex;
 class CZMQAbstractNotifier;
+namespace Consensus {
+struct Params;
+} // namespace Consensus
+namespace interfaces {
+class Mining;
+} // namespace interfaces
 
 class CZMQNotificationInterface final : public CValidationInterface
 {
@@ -25,7 +31,7 @@ public:
 
     std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const;
 
-    static std::unique_ptr<CZMQNotificationInterface> Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index);
+    static std::unique_ptr<CZMQNotificationInterface> Create(std::function<bool(std::vector<std::byte>&, const CBlockIndex&)> get_block_by_index, interfaces::Mining& mining, const Consensus::Params& params);
 
 protected:
     bool Initialize();
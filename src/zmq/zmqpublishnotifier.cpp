@@ -5,15 +5,21 @@
 #include <zmq/zmqpublishnotifier.h>
 
 #include <chain.h>
+#include <consensus/merkle.h>
+#include <consensus/params.h>
 #include <crypto/common.h>
+#include <interfaces/mining.h>
 #include <netaddress.h>
 #include <netbase.h>
+#include <node/mining_types.h>
+#include <pow.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <streams.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/log.h>
+#include <util/thread.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
@@ -23,6 +29,7 @@
 #include <cstdint>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -35,6 +42,10 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_BLOCKTEMPLATE = "blocktemplate";
+
+//! Sockets are shared by the notifiers with the same address, and the block template one sends from its own thread
+static std::mutex g_send_mutex;
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -197,6 +208,7 @@ bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void
     /* send three parts, command & data & a LE 4byte sequence number */
     unsigned char msgseq[sizeof(uint32_t)];
     WriteLE32(msgseq, nSequence);
+    std::lock_guard<std::mutex> lock{g_send_mutex};
     int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
     if (rc == -1)
         return false;
@@ -291,3 +303,105 @@ bool CZMQPublishSequenceNotifier::NotifyTransactionRemoval(const CTransaction &t
     LogDebug(BCLog::ZMQ, "Publish hashtx mempool removal %s to %s\n", hash.GetHex(), this->address);
     return SendSequenceMsg(*this, hash, /* Mempool (R)emoval */ 'R', mempool_sequence);
 }
+
+CZMQPublishBlockTemplateNotifier::CZMQPublishBlockTemplateNotifier(interfaces::Mining& mining, const Consensus::Params& params)
+    : m_mining{mining}, m_params{params} {}
+
+CZMQPublishBlockTemplateNotifier::~CZMQPublishBlockTemplateNotifier()
+{
+    Assume(!m_thread.joinable());
+}
+
+bool CZMQPublishBlockTemplateNotifier::NotifyBlock(const CBlockIndex *pindex)
+{
+    LOCK(m_mutex);
+    if (!m_thread.joinable() && !m_stop) {
+        m_thread = std::thread(&util::TraceThread, "zmqtemplate", [this] { ThreadFeed(); });
+    }
+    return true;
+}
+
+void CZMQPublishBlockTemplateNotifier::Shutdown()
+{
+    {
+        LOCK(m_mutex);
+        m_stop = true;
+        if (m_template) m_template->interruptWait();
+    }
+    if (m_thread.joinable()) {
+        // Also stops the creation of a template while the node is still in initial block download
+        m_mining.interrupt();
+        m_thread.join();
+    }
+    CZMQAbstractPublishNotifier::Shutdown();
+}
+
+void CZMQPublishBlockTemplateNotifier::ThreadFeed()
+{
+    std::unique_ptr<interfaces::BlockTemplate> block_template{m_mining.createNewBlock()};
+    CBlock previous_block;
+    node::BlockWaitOptions wait_options;
+    wait_options.fee_threshold = FEE_THRESHOLD;
+    while (block_template) {
+        interfaces::BlockTemplate* current_template;
+        {
+            LOCK(m_mutex);
+            if (m_stop) break;
+            m_template = std::move(block_template);
+            current_template = m_template.get();
+        }
+        CBlock block{current_template->getBlock()};
+        SendBlockTemplate(block, previous_block);
+        previous_block = std::move(block);
+        // Only this thread replaces m_template, so current_template stays valid while waiting
+        block_template = current_template->waitNext(wait_options);
+    }
+    LOCK(m_mutex);
+    m_template.reset();
+}
+
+// Send a 'blocktemplate' topic message with the following structure:
+//    <1-byte kind: 0 full, 1 delta> | <112-byte header> | <4-byte LE height> | <4-byte LE trailing zeros> |
+//    <compact size + LE target> | <coinbase tx> | <compact size transaction count> | <transactions>
+// The header has the Merkle Root of the template coinbase, and its Target, Trailing Zeros and Offset limit
+// 2^(trailing zeros) are the ones for a nonce with a null Difficulty Offset. In a full template, the transactions
+// follow the coinbase. In a delta one, each transaction is a compact size k, followed by the transaction if k is 0,
+// while k > 0 designates the transaction k - 1 (coinbase excluded) of the previous message.
+bool CZMQPublishBlockTemplateNotifier::SendBlockTemplate(const CBlock& block, const CBlock& previous_block)
+{
+    // The height is in the coinbase lock time
+    const int32_t height(block.vtx.at(0)->nLockTime + 1);
+    const int32_t powVersion(m_params.GetPoWVersionAtHeight(height));
+    CBlockHeader header(block);
+    header.hashMerkleRoot = BlockMerkleRoot(block);
+    const std::optional<uint32_t> trailingZeros(DeriveTrailingZeros(header.nBits, 0, powVersion, m_params.nBitsMin));
+    const std::optional<mpz_class> target(DeriveTarget(header.GetHashForPoW(), header.nBits, 0, powVersion, m_params.nBitsMin));
+    if (!trailingZeros || !target) {
+        zmqError("Invalid block template difficulty");
+        return false;
+    }
+    std::vector<unsigned char> targetBytes((mpz_sizeinbase(target->get_mpz_t(), 2) + 7)/8);
+    mpz_export(targetBytes.data(), nullptr, -1, sizeof(unsigned char), 0, 0, target->get_mpz_t());
+
+    const bool delta(!previous_block.vtx.empty() && previous_block.hashPrevBlock == block.hashPrevBlock);
+    DataStream ss;
+    ss << uint8_t{delta} << header << height << *trailingZeros << targetBytes << TX_WITH_WITNESS(*block.vtx[0]);
+    WriteCompactSize(ss, block.vtx.size() - 1);
+    if (delta) {
+        std::map<Txid, uint64_t> previousIndexes;
+        for (size_t i = 1; i < previous_block.vtx.size(); i++) {
+            previousIndexes.emplace(previous_block.vtx[i]->GetHash(), i);
+        }
+        for (size_t i = 1; i < block.vtx.size(); i++) {
+            const auto it{previousIndexes.find(block.vtx[i]->GetHash())};
+            WriteCompactSize(ss, it == previousIndexes.end() ? 0 : it->second);
+            if (it == previousIndexes.end()) ss << TX_WITH_WITNESS(*block.vtx[i]);
+        }
+    } else {
+        for (size_t i = 1; i < block.vtx.size(); i++) {
+            ss << TX_WITH_WITNESS(*block.vtx[i]);
+        }
+    }
+    LogDebug(BCLog::ZMQ, "Publish %s block template at height %d to %s\n", delta ? "delta" : "full", height, this->address);
+    return SendZmqMessage(MSG_BLOCKTEMPLATE, &(*ss.begin()), ss.size());
+}
@@ -5,15 +5,27 @@
 #ifndef BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <sync.h>
 #include <zmq/zmqabstractnotifier.h>
 
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
 class CBlockIndex;
+namespace Consensus {
+struct Params;
+} // namespace Consensus
+namespace interfaces {
+class BlockTemplate;
+class Mining;
+} // namespace interfaces
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
@@ -72,4 +84,38 @@ public:
     bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence) override;
 };
 
+/**
+ * Push a new block template to constellation miners whenever the tip changes or the mempool
+ * fees rose enough, so they do not have to poll getblocktemplate.
+ *
+ * Besides the template, each message carries the Target, Trailing Zeros and Offset limit of the
+ * header with the Merkle Root of the template coinbase, so miners keeping it can start sieving
+ * right away. When only the mempool changed, the transactions are encoded relatively to the
+ * previous message.
+ */
+class CZMQPublishBlockTemplateNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    interfaces::Mining& m_mining;
+    const Consensus::Params& m_params;
+    Mutex m_mutex;
+    std::thread m_thread;
+    //! Template the feed thread is waiting on, which is only replaced by this thread
+    std::unique_ptr<interfaces::BlockTemplate> m_template GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    void ThreadFeed() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool SendBlockTemplate(const CBlock& block, const CBlock& previous_block);
+
+public:
+    //! Minimum fee increase, in satoshis, of the transactions of a template to publish a new one with the same tip
+    static constexpr CAmount FEE_THRESHOLD{1000};
+
+    CZMQPublishBlockTemplateNotifier(interfaces::Mining& mining, const Consensus::Params& params);
+    ~CZMQPublishBlockTemplateNotifier();
+    //! The feed starts with the first tip, when the chainstate is loaded
+    bool NotifyBlock(const CBlockIndex *pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Shutdown() override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
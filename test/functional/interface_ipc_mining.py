@@ -513,7 +513,7 @@ class IPCMiningTest(BitcoinTestFramework):
 
                 self.log.debug("Submit solution that can't be deserialized")
                 try:
-                    await template.submitSolution(ctx, 0, 0, 0, b"")
+                    await template.submitSolution(ctx, 0, 0, ser_uint256(0), b"")
                     raise AssertionError("submitSolution unexpectedly succeeded")
                 except capnp.lib.capnp.KjException as e:
                     assert_capnp_failed(e, "remote exception: std::exception: SpanReader::read(): end of data:")
@@ -526,7 +526,7 @@ class IPCMiningTest(BitcoinTestFramework):
                 assert_equal(check.reason, "bad-version(0x00000000)")
                 assert_equal(check.debug, "rejected nVersion=0x00000000 block")
                 self.log.debug("submitSolution should reject a bad-version block")
-                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, block.nNonce, coinbase.serialize())).result
+                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, ser_uint256(block.nNonce), coinbase.serialize())).result
                 assert_equal(submitted, False)
                 self.log.debug("submitBlock should reject a bad-version block")
                 await self.assert_submit_block(
@@ -560,7 +560,7 @@ class IPCMiningTest(BitcoinTestFramework):
                 missing_witness_block.hashMerkleRoot = missing_witness_block.calc_merkle_root()
                 missing_witness_block.solve()
                 self.log.debug("submitSolution should reject a coinbase missing witness")
-                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, block.nNonce, coinbase.serialize_without_witness())).result
+                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, ser_uint256(block.nNonce), coinbase.serialize_without_witness())).result
                 assert_equal(submitted, False)
 
                 self.log.debug("Even a rejected submitSolution() mutates the template's block")
@@ -580,7 +580,7 @@ class IPCMiningTest(BitcoinTestFramework):
                 )
 
                 self.log.debug("Submit again, with the witness")
-                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, block.nNonce, coinbase.serialize())).result
+                submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, ser_uint256(block.nNonce), coinbase.serialize())).result
                 assert_equal(submitted, True)
 
                 self.log.debug("Submit a valid complete block through the disconnected node")
@@ -619,7 +619,7 @@ class IPCMiningTest(BitcoinTestFramework):
                 await self.assert_submit_block(mining2, ctx2, duplicate_block, result=True)
                 self.nodes[2].waitforblockheight(current_block_height + 2)
                 self.log.debug("submitSolution should accept the duplicate block")
-                submitted = (await template2.submitSolution(ctx2, duplicate_block.nVersion, duplicate_block.nTime, duplicate_block.nNonce, duplicate_coinbase.serialize())).result
+                submitted = (await template2.submitSolution(ctx2, duplicate_block.nVersion, duplicate_block.nTime, ser_uint256(duplicate_block.nNonce), duplicate_coinbase.serialize())).result
                 assert_equal(submitted, True)
             self.sync_all()
 
@@ -694,7 +694,7 @@ class IPCMiningTest(BitcoinTestFramework):
                     block.vtx[0] = coinbase
                     block.hashMerkleRoot = block.calc_merkle_root()
                     block.solve()
-                    submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, block.nNonce, coinbase.serialize())).result
+                    submitted = (await template.submitSolution(ctx, block.nVersion, block.nTime, ser_uint256(block.nNonce), coinbase.serialize())).result
                     assert_equal(submitted, True)
                     assert_equal(node.getblockcount(), height)
 
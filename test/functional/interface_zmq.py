@@ -6,6 +6,7 @@
 import os
 import struct
 import tempfile
+from decimal import Decimal
 from io import BytesIO
 
 from test_framework.address import (
@@ -19,6 +20,10 @@ from test_framework.blocktools import (
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.messages import (
     CBlock,
+    CBlockHeader,
+    CTransaction,
+    deser_compact_size,
+    deser_string,
     hash256,
     tx_from_hex,
 )
@@ -129,6 +134,7 @@ class ZMQTest (BitcoinTestFramework):
             self.test_reorg()
             self.test_multiple_interfaces()
             self.test_ipv6()
+            self.test_blocktemplate()
         finally:
             # Destroy the ZMQ context.
             self.log.debug("Destroying ZMQ context")
@@ -588,5 +594,122 @@ class ZMQTest (BitcoinTestFramework):
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[0].receive().hex())
 
 
+    def receive_blocktemplate(self, sub):
+        """Receive a blocktemplate message and parse it, the transactions of a delta one being
+        either new ones or indexes k > 0 of the transaction k - 1 of the previous message."""
+        f = BytesIO(sub.receive())
+        kind = f.read(1)[0]
+        header = CBlockHeader()
+        header.deserialize(f)
+        height = int.from_bytes(f.read(4), "little", signed=True)
+        trailing_zeros = int.from_bytes(f.read(4), "little")
+        target = int.from_bytes(deser_string(f), "little")
+        coinbase = CTransaction()
+        coinbase.deserialize(f)
+        entries = []
+        for _ in range(deser_compact_size(f)):
+            index = deser_compact_size(f) if kind == 1 else 0
+            if index > 0:
+                entries.append(index)
+            else:
+                tx = CTransaction()
+                tx.deserialize(f)
+                entries.append(tx)
+        assert_equal(f.read(), b"")
+        return {"kind": kind, "header": header, "height": height, "trailing_zeros": trailing_zeros, "target": target, "coinbase": coinbase, "entries": entries}
+
+    def check_blocktemplate(self, template, txs):
+        """Check a blocktemplate message with the given transactions against getblocktemplate."""
+        node = self.nodes[0]
+        gbt = node.getblocktemplate({"rules": ["segwit"]})
+        header = template["header"]
+        assert_equal(header.hashPrevBlock, int(gbt["previousblockhash"], 16))
+        assert_equal(header.nVersion, gbt["version"])
+        assert_equal(header.nBits, int(gbt["bits"], 16))
+        assert_equal(template["height"], gbt["height"])
+        assert_equal(template["coinbase"].vout[0].nValue, gbt["coinbasevalue"])
+        assert_equal([tx.txid_hex for tx in txs], [tx["txid"] for tx in gbt["transactions"]])
+        # The header commits to the template transactions
+        block = CBlock(header)
+        block.vtx = [template["coinbase"]] + txs
+        assert_equal(header.hashMerkleRoot, block.calc_merkle_root())
+        # Target and Trailing Zeros for a nonce with a null Difficulty Offset, with PoW Version 1
+        assert_equal(gbt["powversion"], 1)
+        difficulty, df = header.nBits // 256, header.nBits % 256
+        length = (10*df*df*df + 7383*df*df + 5840720*df + 3997440) // 8388608
+        assert_equal(template["trailing_zeros"], difficulty - 264)
+        assert_equal(template["target"], ((1 << 264) + (length << 256) + header.hash_int_pow) << template["trailing_zeros"])
+
+    def test_blocktemplate(self):
+        self.log.info("Test the blocktemplate notification")
+        node = self.nodes[0]
+        address = f"tcp://127.0.0.1:{self.zmq_port_base}"
+        socket = self.ctx.socket(zmq.SUB)
+        blocktemplate = ZMQSubscriber(socket, b"blocktemplate")
+        self.restart_node(0, [f"-zmqpubblocktemplate={address}"])
+        socket.connect(address)
+
+        # The template of the tip may have been published before the subscription, so sync up with the one of a new tip
+        socket.set(zmq.RCVTIMEO, 1000)
+        template = None
+        while template is None:
+            tip = self.generate(node, 1, sync_fun=self.no_op)[0]
+            try:
+                while template is None or template["header"].hashPrevBlock != int(tip, 16):
+                    template = self.receive_blocktemplate(blocktemplate)
+            except zmq.error.Again:
+                self.log.debug("Didn't receive the template of the new tip, trying again.")
+                template = None
+        socket.set(zmq.RCVTIMEO, int(60 * self.options.timeout_factor * 1000))
+
+        self.log.info("A new tip is published as a full template")
+        assert_equal(template["kind"], 0)
+        assert_equal(template["height"], node.getblockcount() + 1)
+        assert_equal(template["entries"], [])
+        self.check_blocktemplate(template, [])
+        txs = []
+
+        def receive_delta():
+            sequence = blocktemplate.sequence
+            delta = self.receive_blocktemplate(blocktemplate)
+            assert_equal(blocktemplate.sequence, sequence + 1)
+            assert_equal(delta["kind"], 1)
+            assert_equal(delta["header"].hashPrevBlock, int(tip, 16))
+            new_txs = [txs[entry - 1] if isinstance(entry, int) else entry for entry in delta["entries"]]
+            self.check_blocktemplate(delta, new_txs)
+            removed = {tx.txid_hex for tx in txs} - {tx.txid_hex for tx in new_txs}
+            return delta, new_txs, removed
+
+        self.log.info("A new mempool transaction is published as a delta adding it")
+        utxo = self.wallet.get_utxo(confirmed_only=True)
+        replaced_tx = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo)["tx"]
+        delta, txs, removed = receive_delta()
+        assert_equal([entry.txid_hex for entry in delta["entries"]], [replaced_tx.txid_hex])
+        assert_equal(removed, set())
+
+        self.log.info("Transactions of the previous template are referenced by their index")
+        other_tx = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=self.wallet.get_utxo(confirmed_only=True))["tx"]
+        delta, txs, removed = receive_delta()
+        assert_equal(sorted((entry if isinstance(entry, int) else entry.txid_hex for entry in delta["entries"]), key=str), sorted([1, other_tx.txid_hex], key=str))
+        assert_equal(removed, set())
+
+        self.log.info("A replaced transaction is removed by the delta")
+        replacement_tx = self.wallet.send_self_transfer(from_node=node, utxo_to_spend=utxo, fee_rate=Decimal("0.1"))["tx"]
+        delta, txs, removed = receive_delta()
+        assert_equal(removed, {replaced_tx.txid_hex})
+        assert_equal({tx.txid_hex for tx in txs}, {replacement_tx.txid_hex, other_tx.txid_hex})
+        assert_equal([entry.txid_hex for entry in delta["entries"] if not isinstance(entry, int)], [replacement_tx.txid_hex])
+
+        self.log.info("A new tip is published as a full template again")
+        sequence = blocktemplate.sequence
+        tip = self.generate(node, 1, sync_fun=self.no_op)[0]
+        template = self.receive_blocktemplate(blocktemplate)
+        assert_equal(blocktemplate.sequence, sequence + 1)
+        assert_equal(template["kind"], 0)
+        assert_equal(template["header"].hashPrevBlock, int(tip, 16))
+        assert_equal(template["entries"], [])
+        self.check_blocktemplate(template, [])
+
+
 if __name__ == '__main__':
     ZMQTest(__file__).main()
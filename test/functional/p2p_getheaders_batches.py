@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# Copyright (c) 2013-present The Riecoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test getheaders responses for complete batches of headers, which are served from a cache.
+"""
+
+from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
+from test_framework.messages import (
+    CBlockHeader,
+    msg_getheaders,
+)
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+MAX_HEADERS_RESULTS = 2000
+
+
+class HeadersCollector(P2PInterface):
+    def __init__(self):
+        super().__init__()
+        self.responses = []
+
+    def on_headers(self, message):
+        self.responses.append([CBlockHeader(header).hash_hex for header in message.headers])
+
+
+class GetHeadersBatchesTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def get_headers(self, peer, locator, hash_stop=0):
+        msg = msg_getheaders()
+        msg.locator.vHave = [int(h, 16) for h in locator]
+        msg.hashstop = hash_stop
+        count = len(peer.responses)
+        peer.send_without_ping(msg)
+        peer.wait_until(lambda: len(peer.responses) > count)
+        return peer.responses[-1]
+
+    def run_test(self):
+        node = self.nodes[0]
+        address = node.get_deterministic_priv_key().address
+        self.generatetoaddress(node, MAX_HEADERS_RESULTS + 10 - node.getblockcount(), address)
+        chain = [node.getblockhash(height) for height in range(node.getblockcount() + 1)]
+
+        self.log.info("Complete batches are the same for all the peers")
+        peers = [node.add_p2p_connection(HeadersCollector()) for _ in range(2)]
+        for peer in peers:
+            for _ in range(2):
+                assert_equal(self.get_headers(peer, [chain[0]]), chain[1:MAX_HEADERS_RESULTS + 1])
+
+        self.log.info("Requests not matching a batch are answered normally")
+        assert_equal(self.get_headers(peers[0], [chain[1]]), chain[2:MAX_HEADERS_RESULTS + 2])
+        assert_equal(self.get_headers(peers[0], [chain[0]], int(chain[1500], 16)), chain[1:1501])
+        assert_equal(self.get_headers(peers[0], [chain[0]], int(chain[MAX_HEADERS_RESULTS], 16)), chain[1:MAX_HEADERS_RESULTS + 1])
+        assert_equal(self.get_headers(peers[0], [chain[MAX_HEADERS_RESULTS]]), chain[MAX_HEADERS_RESULTS + 1:])
+
+        self.log.info("A reorganized batch is served from the new chain")
+        node.invalidateblock(chain[1990])
+        # Mine to another address so the new blocks differ from the invalidated ones
+        self.generatetoaddress(node, 20, ADDRESS_BCRT1_UNSPENDABLE)
+        new_chain = [node.getblockhash(height) for height in range(node.getblockcount() + 1)]
+        assert new_chain[MAX_HEADERS_RESULTS] != chain[MAX_HEADERS_RESULTS]
+        for peer in peers:
+            assert_equal(self.get_headers(peer, [chain[0]]), new_chain[1:MAX_HEADERS_RESULTS + 1])
+
+
+if __name__ == '__main__':
+    GetHeadersBatchesTest(__file__).main()
@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+# Copyright (c) 2013-present The Riecoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the getdbstats RPC and the database tuning options.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+)
+
+
+class GetDBStatsTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [["-txindex", "-dbbloombits=chainstate:0", "-dbmaxfilesize=4"]]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wait_until(lambda: node.getindexinfo()["txindex"]["synced"])
+
+        self.log.info("Every database reports its statistics")
+        stats = node.getdbstats()
+        assert_equal(sorted(stats), ["blockindex", "chainstate", "txindex"])
+        for db in stats.values():
+            assert_equal(len(db["levels"]), 7)
+            assert_greater_than(db["memory_usage"], 0)
+            assert_equal(db["write_stalls"], 0)
+
+        self.log.info("The bloom filters follow the per-database option")
+        assert "bloom_checks" not in stats["chainstate"]
+        assert "bloom_rejection_rate" in stats["blockindex"]
+
+        self.log.info("Lookups are counted")
+        txid = node.getblock(node.getblockhash(1))["tx"][0]
+        node.getrawtransaction(txid)
+        assert_greater_than(node.getdbstats()["txindex"]["lookups"], stats["txindex"]["lookups"])
+
+        self.log.info("Invalid tuning options are rejected")
+        self.stop_node(0)
+        node.assert_start_raises_init_error(["-dbbloombits=wallet:10"], "Error: Unknown database wallet in -dbbloombits=wallet:10.")
+        node.assert_start_raises_init_error(["-dbwritebuffersize=0"], "Error: Invalid -dbwritebuffersize=0, the value must be between 1 and 1024.")
+
+
+if __name__ == '__main__':
+    GetDBStatsTest(__file__).main()
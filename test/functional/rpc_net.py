@@ -167,6 +167,7 @@ class NetTest(BitcoinTestFramework):
                 "minfeefilter": Decimal("0E-8"),
                 "network": "not_publicly_routable",
                 "permissions": [],
+                "pow_check_time": 0,
                 "relaytxes": False,
                 "inv_to_send": 0,
                 "last_inv_sequence": 0,
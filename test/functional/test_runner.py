@@ -241,6 +241,7 @@ BASE_SCRIPTS = [
     'p2p_blocksonly.py',
     'mining_prioritisetransaction.py',
     'p2p_invalid_locator.py',
+    'p2p_getheaders_batches.py',
     'p2p_invalid_block.py --v1transport',
     'p2p_invalid_block.py --v2transport',
     'p2p_invalid_tx.py --v1transport',
@@ -301,6 +302,7 @@ BASE_SCRIPTS = [
     'feature_reindex_init.py',
     # 'feature_cltv.py', # Needs to be rewritten without (pre)activation
     'rpc_uptime.py',
+    'rpc_getdbstats.py',
     'feature_discover.py',
     'wallet_resendwallettransactions.py',
     'wallet_fallbackfee.py',